@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_async.c
+ *
+ * Formatting for outputs that can't always take a character.
+ *
+ * The putc of a file descriptor has no way to say that it is busy, so a
+ * slow output such as a UART FIFO or a USB endpoint has to wait inside
+ * putc, and the caller of spe_fprintf() with it. The output here has a
+ * putc that instead returns non-zero when the character would block.
+ * spe_async_printf() then returns the number of characters still pending,
+ * and spe_async_resume() continues from there later, from the idle loop, a
+ * scheduler tick or the interrupt saying there is room again.
+ *
+ * \code
+ * static char uart_buf[256];
+ * static struct spe_async uart = SPE_ASYNC_SETUP(uart_buf, uart_try_putc);
+ *
+ * spe_async_printf(&uart, "Temperature %d\n", temp);
+ * ...
+ * while (spe_async_resume(&uart) > 0) {
+ *     do_other_work();
+ * }
+ * \endcode
+ *
+ * The arguments of a call are gone when it returns, a va_list can't be
+ * kept for later, so every call is formatted in full into the buffer and
+ * only the delivery is resumed. The buffer is a queue, more output can be
+ * printed while earlier output is pending. A call whose text doesn't fit
+ * in the room left queues nothing and returns -1, so no characters are
+ * lost without the caller knowing. It can be retried once more of the
+ * buffer has been delivered.
+ *
+ * An output must not be used concurrently, but printing from a task and
+ * resuming from another one is fine if they are serialised.
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "spe_printf.h"
+#include "spe_async.h"
+
+
+/**
+ * \b drain
+ *
+ * Hand pending characters to putc until it would block.
+ * This is an internal function not for use by application code.
+ *
+ * @param as The output.
+ *
+ * @retval Number of characters still pending.
+ */
+static int
+drain(struct spe_async *as)
+{
+    while ((as->sent < as->len) && !as->putc(as->buf[as->sent])) {
+        as->sent++;
+    }
+    if (as->sent == as->len) {
+        as->sent = 0;
+        as->len = 0;
+    }
+
+    return (int)(as->len - as->sent);
+} /* drain */
+
+
+/**
+ * \b spe_async_printf
+ *
+ * Print to an output that may refuse characters, without waiting for it.
+ *
+ * @param as The output.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval >=0 Number of characters still pending, 0 when all was taken.
+ * @retval -1 On failure, or if the text didn't fit in the buffer. Then
+ *          nothing of it was queued.
+ */
+int
+spe_async_printf(struct spe_async *as, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_async_vprintf(as, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_async_printf */
+
+
+/**
+ * \b spe_async_vprintf
+ *
+ * Variadic version of spe_async_printf().
+ *
+ * @param as The output.
+ * @param fmt Format string for formatting the text.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval >=0 Number of characters still pending, 0 when all was taken.
+ * @retval -1 On failure, or if the text didn't fit in the buffer. Then
+ *          nothing of it was queued.
+ */
+int
+spe_async_vprintf(struct spe_async *as, const char *fmt, va_list ap)
+{
+    SPE_FILE strfd = {
+        .putc = NULL,
+        .str = NULL,
+        .curr = 0,
+        .full = 0,
+    };
+
+    /* Make room behind what is already pending */
+    if (drain(as) && as->sent) {
+        memmove(as->buf, &as->buf[as->sent], as->len - as->sent);
+        as->len -= as->sent;
+        as->sent = 0;
+    }
+
+    /*
+     * Formatted straight behind the pending characters, without a
+     * terminating \0, so the file descriptor gets one more character than
+     * the room. It is marked full only when a character had to be dropped,
+     * so text that exactly fills the room is still taken.
+     */
+    strfd.str = &as->buf[as->len];
+    strfd.max = as->size - as->len + 1;
+    if ((spe_vfprintf(&strfd, fmt, ap) < 0) || strfd.full) {
+        return -1;
+    }
+    as->len += strfd.curr;
+
+    return drain(as);
+} /* spe_async_vprintf */
+
+
+/**
+ * \b spe_async_resume
+ *
+ * Continue delivering pending characters until putc would block again.
+ *
+ * @param as The output.
+ *
+ * @retval >=0 Number of characters still pending, 0 when all was taken.
+ */
+int
+spe_async_resume(struct spe_async *as)
+{
+    return drain(as);
+} /* spe_async_resume */
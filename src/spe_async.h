@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_ASYNC_H
+#define SPE_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stddef.h> /* size_t */
+
+/**
+ * Output that may refuse characters. Use macro SPE_ASYNC_SETUP for
+ * initialisation.\n
+ * Don't modify directly.
+ */
+struct spe_async {
+    char *buf;              /*!< Characters not yet taken by putc */
+    size_t size;            /*!< Size of buf */
+    size_t len;             /*!< Characters in buf */
+    size_t sent;            /*!< Characters of buf taken by putc */
+    int (*putc)(char c);    /*!< Returns 0 if the character was taken,
+                                 non-zero if it would block */
+};
+
+/**
+ * Set up an output from a buffer array and a non-blocking putc.
+ */
+#define SPE_ASYNC_SETUP(b, putc_fn)                     \
+    {                                                   \
+        .buf = b,                                       \
+        .size = sizeof(b),                              \
+        .len = 0,                                       \
+        .sent = 0,                                      \
+        .putc = putc_fn,                                \
+    }
+
+int spe_async_printf(struct spe_async *as, const char *fmt, ...)
+    __attribute__((__format__(__printf__, 2, 3)));
+int spe_async_vprintf(struct spe_async *as, const char *fmt, va_list ap)
+    __attribute__((__format__(__printf__, 2, 0)));
+int spe_async_resume(struct spe_async *as);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_ASYNC_H */
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_column.c
+ *
+ * Arrays of integers as decimal text, for exporting columns of readings.
+ *
+ * Printing a long array with spe_fprintf("%u,", ...) parses the format and
+ * divides out the digits one at a time for every value. Here the values
+ * are converted straight into a chunk on the stack, separators included,
+ * and each full chunk is handed to the file descriptor at once.
+ *
+ * Where the target has 64 bit little endian words, the eight lower digits
+ * of a value are converted at once within a register (SWAR, SIMD within a
+ * register): the value is split in two halves of four digits, each half in
+ * two pairs and each pair in two digits, by multiplying with a reciprocal
+ * and shifting, all halves, pairs and digits in parallel. The first digit
+ * ends up in the lowest byte, so leading zeros are dropped by shifting the
+ * word down. Values of nine or ten digits get the first one or two digits
+ * with a division. Elsewhere the digits are divided out one by one.
+ *
+ * Values are converted one at a time, there are no vector instructions.
+ * The gain over spe_fprintf() comes from not parsing a format and from
+ * the digits in parallel within a value. The u32_array and u32_fprintf
+ * cases of tests/Bench measure the same eight values both ways, and the
+ * bench fails if the array isn't faster.
+ *
+ * \code
+ * uint32_t samples[256];
+ *
+ * spe_fput_u32_array(&uart, samples, 256, ",");
+ * \endcode
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "spe_column.h"
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SPE_SWAR
+#endif
+
+/* Longest value, "-2147483648" */
+#define MAX_FIELD 11
+
+#ifdef SPE_SWAR
+/**
+ * \b eight_digits
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Split a value below 100000000 into eight digits at once, the first digit
+ * in the lowest byte. x / 100 is done as (x * 5243) >> 19 and x / 10 as
+ * (x * 103) >> 10, which are exact for the ranges used and never carry
+ * into the neighbouring lane.
+ *
+ * @param value Value below 100000000.
+ *
+ * @retval The digits, 0 to 9 in each byte.
+ */
+static uint64_t
+eight_digits(const uint32_t value)
+{
+    const uint64_t halves = (uint64_t)(value / 10000U) |
+        ((uint64_t)(value % 10000U) << 32);
+    const uint64_t hundreds = ((halves * 5243U) >> 19) &
+        0x0000007f0000007fULL;
+    const uint64_t pairs = hundreds | ((halves - hundreds * 100U) << 16);
+    const uint64_t tens = ((pairs * 103U) >> 10) & 0x000f000f000f000fULL;
+
+    return tens | ((pairs - tens * 10U) << 8);
+} /* eight_digits */
+
+
+/**
+ * \b leading_zeros
+ *
+ * This is an internal function not for use by application code.
+ *
+ * @param digits Digits from eight_digits(), not all zero.
+ *
+ * @retval Number of leading zero digits.
+ */
+static unsigned int
+leading_zeros(uint64_t digits)
+{
+#ifdef __GNUC__
+    return (unsigned int)__builtin_ctzll(digits) / 8U;
+#else
+    unsigned int zeros = 0;
+
+    for (; !(digits & 0xffU); digits >>= 8) {
+        zeros++;
+    }
+    return zeros;
+#endif
+} /* leading_zeros */
+#endif /* SPE_SWAR */
+
+
+/**
+ * \b u32_decimal
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Write value in decimal, without terminating \0.
+ *
+ * @param value Value to write.
+ * @param out Room for 10 characters.
+ *
+ * @retval Number of characters written.
+ */
+static size_t
+u32_decimal(uint32_t value, char *out)
+{
+    size_t len = 0;
+
+#ifdef SPE_SWAR
+    uint64_t digits;
+    unsigned int zeros = 0;
+
+    if (value >= 100000000U) {
+        const uint32_t top = value / 100000000U;
+
+        value -= top * 100000000U;
+        if (top >= 10U) {
+            out[len++] = (char)('0' + top / 10U);
+        }
+        out[len++] = (char)('0' + top % 10U);
+    } else if (value == 0U) {
+        out[0] = '0';
+        return 1;
+    }
+    digits = eight_digits(value);
+    if (!len) {
+        zeros = leading_zeros(digits);
+        digits >>= zeros * 8U;
+    }
+    digits += 0x3030303030303030ULL;
+    memcpy(&out[len], &digits, 8U - zeros);
+    return len + 8U - zeros;
+#else
+    char reversed[10];
+    size_t i;
+
+    do {
+        reversed[len++] = (char)('0' + value % 10U);
+        value /= 10U;
+    } while (value);
+    for (i = 0; i < len; i++) {
+        out[i] = reversed[len - 1U - i];
+    }
+    return len;
+#endif
+} /* u32_decimal */
+
+
+/**
+ * \b put_array
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Common part of spe_fput_u32_array() and spe_fput_i32_array(), exactly
+ * one of unsigned_values and signed_values is given.
+ *
+ * @param fd A pointer to the file descriptor.
+ * @param unsigned_values Array of unsigned values, or NULL.
+ * @param signed_values Array of signed values, or NULL.
+ * @param count Number of values.
+ * @param separator Text between values.
+ */
+static void
+put_array(SPE_FILE *fd, const uint32_t *unsigned_values,
+          const int32_t *signed_values, size_t count, const char *separator)
+{
+    char chunk[SPE_COLUMN_CHUNK + 1];
+    size_t len = 0;
+    size_t i;
+
+    for (i = 0; (i < count) && !fd->full; i++) {
+        uint32_t value;
+        const char *sep;
+
+        if (len > SPE_COLUMN_CHUNK - MAX_FIELD) {
+            chunk[len] = '\0';
+            spe_fputs(chunk, fd);
+            len = 0;
+        }
+        if (unsigned_values) {
+            value = unsigned_values[i];
+        } else if (signed_values[i] < 0) {
+            chunk[len++] = '-';
+            value = 0U - (uint32_t)signed_values[i];
+        } else {
+            value = (uint32_t)signed_values[i];
+        }
+        len += u32_decimal(value, &chunk[len]);
+
+        for (sep = separator; (i + 1 < count) && *sep; sep++) {
+            if (len == SPE_COLUMN_CHUNK) {
+                chunk[len] = '\0';
+                spe_fputs(chunk, fd);
+                len = 0;
+            }
+            chunk[len++] = *sep;
+        }
+    }
+    chunk[len] = '\0';
+    spe_fputs(chunk, fd);
+} /* put_array */
+
+
+/**
+ * \b spe_fput_u32_array
+ *
+ * Print an array of unsigned values in decimal, with separator between
+ * them, as spe_fprintf() with "%u" and separator for each would.
+ *
+ * @param fd A pointer to the file descriptor.
+ * @param values The values.
+ * @param count Number of values.
+ * @param separator Text between values, may be empty.
+ *
+ * @retval 0 On success.
+ */
+int
+spe_fput_u32_array(SPE_FILE *fd, const uint32_t *values, size_t count,
+                   const char *separator)
+{
+    put_array(fd, values, NULL, count, separator);
+
+    return 0;
+} /* spe_fput_u32_array */
+
+
+/**
+ * \b spe_fput_i32_array
+ *
+ * Print an array of signed values in decimal, with separator between
+ * them, as spe_fprintf() with "%d" and separator for each would.
+ *
+ * @param fd A pointer to the file descriptor.
+ * @param values The values.
+ * @param count Number of values.
+ * @param separator Text between values, may be empty.
+ *
+ * @retval 0 On success.
+ */
+int
+spe_fput_i32_array(SPE_FILE *fd, const int32_t *values, size_t count,
+                   const char *separator)
+{
+    put_array(fd, NULL, values, count, separator);
+
+    return 0;
+} /* spe_fput_i32_array */
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_COLUMN_H
+#define SPE_COLUMN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+
+#include "spe_printf.h"
+
+/**
+ * Characters converted on the stack before they are handed to the file
+ * descriptor in one go. At least 16.
+ */
+#ifndef SPE_COLUMN_CHUNK
+#define SPE_COLUMN_CHUNK 64
+#endif
+
+int spe_fput_u32_array(SPE_FILE *fd, const uint32_t *values, size_t count,
+                       const char *separator);
+int spe_fput_i32_array(SPE_FILE *fd, const int32_t *values, size_t count,
+                       const char *separator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_COLUMN_H */
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_crash.c
+ *
+ * Crash log in RAM that survives a reset.
+ *
+ * The last lines before a fault are the ones that explain it, and they are
+ * usually lost with the fault. Here they go into a circular region placed
+ * in RAM that the startup code leaves alone, and are read back after the
+ * reset that followed. On Linux a file mapped with mmap() makes a region
+ * that survives the process, for testing.
+ *
+ * \code
+ * static uint32_t crash_mem[256] SPE_CRASH_NOINIT;
+ * static struct spe_crash *crash;
+ *
+ * static void crash_putc(char c) { spe_crash_putc(crash, c); }
+ * static SPE_FILE crash_output = SPE_PRINTF_SETUP(crash_putc);
+ * SPE_FILE *spe_stderr = &crash_output;
+ *
+ * crash = spe_crash_attach(crash_mem, sizeof(crash_mem));
+ * len = spe_crash_read(crash, text, sizeof(text));
+ * \endcode
+ *
+ * Writing never blocks, allocates or takes a lock, so it can be done from
+ * interrupts and fault handlers. A writer reserves its bytes by moving the
+ * head with a compare and swap, which is retried if an interrupt moved the
+ * head in between, and then copies into the bytes it got. A whole line of
+ * spe_crash_printf() is one reservation, so lines from different contexts
+ * don't mix. A writer stopped between reservation and copy, by the crash
+ * itself, leaves the bytes of its reservation as they were.
+ *
+ * The compare and swap is the one of gcc, LDREX/STREX on Cortex-M3 and up.
+ * For a core without them, define SPE_CRASH_CAS to one that disables
+ * interrupts around the comparison.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "spe_printf.h"
+#include "spe_crash.h"
+
+#ifndef SPE_CRASH_CAS
+#define SPE_CRASH_CAS(ptr, expected, desired)                           \
+    __atomic_compare_exchange_n(ptr, expected, desired, 0,              \
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+
+/**
+ * \b text_of
+ *
+ * This is an internal function not for use by application code.
+ *
+ * @param log The crash log.
+ *
+ * @retval The text, following the header.
+ */
+static char *
+text_of(const struct spe_crash *log)
+{
+    return (char *)(uintptr_t)(log + 1);
+} /* text_of */
+
+
+/**
+ * \b reserve
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Move the head past len bytes, wrapping around at the end.
+ *
+ * @param log The crash log.
+ * @param len Number of bytes, at most the size of the log.
+ *
+ * @retval Position of the first byte reserved.
+ */
+static uint32_t
+reserve(struct spe_crash *log, const uint32_t len)
+{
+    uint32_t head = log->head;
+    uint32_t pos, next;
+
+    do {
+        pos = head & ~SPE_CRASH_WRAPPED;
+        next = pos + len;
+        if (next >= log->size) {
+            next = (next - log->size) | SPE_CRASH_WRAPPED;
+        } else {
+            next |= head & SPE_CRASH_WRAPPED;
+        }
+    } while (!SPE_CRASH_CAS(&log->head, &head, next));
+
+    return pos;
+} /* reserve */
+
+
+/**
+ * \b spe_crash_attach
+ *
+ * Take a region into use as crash log. The log found in it is kept if it
+ * is valid, so it can be read, otherwise the region starts out empty.
+ *
+ * @param mem The region, aligned for uint32_t.
+ * @param size Size of the region in bytes.
+ *
+ * @retval The crash log.
+ * @retval NULL if the region is too small or not aligned.
+ */
+struct spe_crash *
+spe_crash_attach(void *mem, size_t size)
+{
+    struct spe_crash *log = mem;
+    uint32_t text_size;
+
+    if (!mem || ((uintptr_t)mem % sizeof(uint32_t)) ||
+        (size <= sizeof(*log))) {
+        return NULL;
+    }
+    size -= sizeof(*log);
+    text_size = (size < SPE_CRASH_WRAPPED) ? (uint32_t)size :
+        SPE_CRASH_WRAPPED - 1U;
+
+    if ((log->magic != SPE_CRASH_MAGIC) || (log->size != text_size) ||
+        (log->check != ~(log->magic ^ log->size)) ||
+        ((log->head & ~SPE_CRASH_WRAPPED) >= text_size)) {
+        log->magic = 0;
+        log->size = text_size;
+        log->head = 0;
+        log->check = ~(SPE_CRASH_MAGIC ^ text_size);
+        log->magic = SPE_CRASH_MAGIC;
+    }
+
+    return log;
+} /* spe_crash_attach */
+
+
+/**
+ * \b spe_crash_clear
+ *
+ * Empty the log, for instance once it has been read and reported.
+ *
+ * @param log The crash log.
+ */
+void
+spe_crash_clear(struct spe_crash *log)
+{
+    log->head = 0;
+} /* spe_crash_clear */
+
+
+/**
+ * \b spe_crash_write
+ *
+ * Append text to the log in one reservation. If it is longer than the log,
+ * only its end is kept.
+ *
+ * @param log The crash log.
+ * @param text The characters to append.
+ * @param len Number of characters.
+ */
+void
+spe_crash_write(struct spe_crash *log, const char *text, size_t len)
+{
+    char *dest = text_of(log);
+    uint32_t pos, first;
+
+    if (len > log->size) {
+        text += len - log->size;
+        len = log->size;
+    }
+    if (!len) {
+        return;
+    }
+
+    pos = reserve(log, (uint32_t)len);
+    first = log->size - pos;
+    if (first > len) {
+        first = (uint32_t)len;
+    }
+    memcpy(&dest[pos], text, first);
+    memcpy(dest, &text[first], len - first);
+} /* spe_crash_write */
+
+
+/**
+ * \b spe_crash_putc
+ *
+ * Append a character to the log, the putc of a file descriptor printing
+ * to it.
+ *
+ * @param log The crash log.
+ * @param c Character to append.
+ */
+void
+spe_crash_putc(struct spe_crash *log, char c)
+{
+    spe_crash_write(log, &c, 1);
+} /* spe_crash_putc */
+
+
+/**
+ * \b spe_crash_printf
+ *
+ * Append a line to the log. It is formatted on the stack, at most
+ * SPE_CRASH_LINE - 1 characters, and appended in one reservation.
+ *
+ * @param log The crash log.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval >=0 Number of characters appended.
+ * @retval -1 On failure.
+ */
+int
+spe_crash_printf(struct spe_crash *log, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_crash_vprintf(log, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_crash_printf */
+
+
+/**
+ * \b spe_crash_vprintf
+ *
+ * Variadic version of spe_crash_printf().
+ *
+ * @param log The crash log.
+ * @param fmt Format string for formatting the text.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval >=0 Number of characters appended.
+ * @retval -1 On failure.
+ */
+int
+spe_crash_vprintf(struct spe_crash *log, const char *fmt, va_list ap)
+{
+    char line[SPE_CRASH_LINE];
+    /* Includes the terminating \0. No %pT cache, lines come from any
+     * context and a shared cache would not be reentrant */
+    const int len = spe_vsnprintf(line, sizeof(line), fmt, ap);
+
+    if (len < 1) {
+        return -1;
+    }
+    spe_crash_write(log, line, (size_t)len - 1);
+
+    return len - 1;
+} /* spe_crash_vprintf */
+
+
+/**
+ * \b spe_crash_read
+ *
+ * Copy the text of the log, oldest first. If out is too small, the newest
+ * size characters are copied. Once the log has wrapped around, its first
+ * line is likely cut. No \0 is added.
+ *
+ * @param log The crash log.
+ * @param out Where to copy the text.
+ * @param size Size of out.
+ *
+ * @retval Number of characters copied.
+ */
+size_t
+spe_crash_read(const struct spe_crash *log, char *out, size_t size)
+{
+    const char *text = text_of(log);
+    const uint32_t head = log->head;
+    const uint32_t pos = head & ~SPE_CRASH_WRAPPED;
+    uint32_t start = (head & SPE_CRASH_WRAPPED) ? pos : 0;
+    size_t len = (head & SPE_CRASH_WRAPPED) ? log->size : pos;
+    size_t first;
+
+    if (len > size) {
+        start += (uint32_t)(len - size);
+        len = size;
+    }
+    if (start >= log->size) {
+        start -= log->size;
+    }
+    first = log->size - start;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(out, &text[start], first);
+    memcpy(&out[first], text, len - first);
+
+    return len;
+} /* spe_crash_read */
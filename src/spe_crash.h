@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_CRASH_H
+#define SPE_CRASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+
+/**
+ * Placement of the region of a crash log, in RAM that the startup code
+ * neither clears nor initialises. The linker script needs a matching
+ * NOLOAD output section.
+ */
+#ifndef SPE_CRASH_NOINIT
+#define SPE_CRASH_NOINIT __attribute__((__section__(".noinit")))
+#endif
+
+/** Longest line of spe_crash_printf(), formatted on the stack */
+#ifndef SPE_CRASH_LINE
+#define SPE_CRASH_LINE 96
+#endif
+
+/** Marks a region holding a crash log */
+#define SPE_CRASH_MAGIC ((uint32_t)0x53504543UL)
+
+/** Bit of head set once the log has wrapped around */
+#define SPE_CRASH_WRAPPED ((uint32_t)0x80000000UL)
+
+/**
+ * Crash log, at the start of its region and followed by the text. Use
+ * spe_crash_attach() for initialisation.\n
+ * Don't modify directly.
+ */
+struct spe_crash {
+    uint32_t magic;             /*!< SPE_CRASH_MAGIC when valid */
+    uint32_t size;              /*!< Bytes of text after the header */
+    volatile uint32_t head;     /*!< Next position, and SPE_CRASH_WRAPPED */
+    uint32_t check;             /*!< ~(magic ^ size) */
+};
+
+struct spe_crash *spe_crash_attach(void *mem, size_t size);
+void spe_crash_clear(struct spe_crash *log);
+void spe_crash_write(struct spe_crash *log, const char *text, size_t len);
+void spe_crash_putc(struct spe_crash *log, char c);
+int spe_crash_printf(struct spe_crash *log, const char *fmt, ...)
+    __attribute__((__format__(__printf__, 2, 3)));
+int spe_crash_vprintf(struct spe_crash *log, const char *fmt, va_list ap)
+    __attribute__((__format__(__printf__, 2, 0)));
+size_t spe_crash_read(const struct spe_crash *log, char *out, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_CRASH_H */
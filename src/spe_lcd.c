@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_lcd.c
+ *
+ * Character display that only writes what changed.
+ *
+ * Status screens are typically printed again and again with mostly the
+ * same contents, and a character display bus is slow, some 40 us per
+ * character on a HD44780. Each line is formatted into a staging buffer,
+ * padded with spaces to the width of the display and compared with a
+ * shadow of what the display shows. Only the cells that differ are
+ * written, moving the cursor with the move hook when the next changed
+ * cell is not where the cursor already is. The display is expected to
+ * move the cursor one step right after every character, as they do.
+ *
+ * \code
+ * static char lcd_shadow[2 * 16];
+ * static char lcd_line[16 + 1];
+ * static struct spe_lcd lcd = SPE_LCD_SETUP(lcd_shadow, lcd_line,
+ *                                           hd44780_move, hd44780_putc);
+ *
+ * spe_lcd_printf(&lcd, 0, "T %3d.%d C", t / 10, t % 10);
+ * \endcode
+ *
+ * Text beyond the width of the display is cut, and a newline ends the
+ * line. The shadow starts out as \\0, which never matches, so the first
+ * print of a row writes all of it. Call spe_lcd_invalidate() after the
+ * display has been cleared or reset behind the back of the sink.
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "spe_printf.h"
+#include "spe_lcd.h"
+
+
+/**
+ * \b spe_lcd_invalidate
+ *
+ * Forget what the display shows, so everything is written the next time.
+ *
+ * @param lcd The display.
+ */
+void
+spe_lcd_invalidate(struct spe_lcd *lcd)
+{
+    memset(lcd->shadow, 0, (size_t)lcd->rows * (size_t)lcd->cols);
+    lcd->row = -1;
+} /* spe_lcd_invalidate */
+
+
+/**
+ * \b spe_lcd_printf
+ *
+ * Print a row of the display, writing only the cells that changed.
+ *
+ * @param lcd The display.
+ * @param row Row to print, from 0.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval >=0 Number of characters and cursor moves sent to the display.
+ * @retval -1 On failure.
+ */
+int
+spe_lcd_printf(struct spe_lcd *lcd, int row, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_lcd_vprintf(lcd, row, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_lcd_printf */
+
+
+/**
+ * \b spe_lcd_vprintf
+ *
+ * Variadic version of spe_lcd_printf().
+ *
+ * @param lcd The display.
+ * @param row Row to print, from 0.
+ * @param fmt Format string for formatting the text.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval >=0 Number of characters and cursor moves sent to the display.
+ * @retval -1 On failure.
+ */
+int
+spe_lcd_vprintf(struct spe_lcd *lcd, int row, const char *fmt, va_list ap)
+{
+    char *shadow;
+    int len, col;
+    int sent = 0;
+
+    if ((row < 0) || (row >= lcd->rows)) {
+        return -1;
+    }
+    /* Includes the terminating \0 */
+#ifdef USE_TIMESTAMP
+    len = spe_vsnprintf_cache(lcd->line, (size_t)lcd->cols + 1, &lcd->tcache,
+                              fmt, ap);
+#else
+    len = spe_vsnprintf(lcd->line, (size_t)lcd->cols + 1, fmt, ap);
+#endif
+    if (len < 0) {
+        return -1;
+    }
+    for (col = 0; (col < len - 1) && (lcd->line[col] != '\n'); col++) {
+    }
+    for (; col < lcd->cols; col++) {
+        lcd->line[col] = ' ';
+    }
+
+    shadow = &lcd->shadow[row * lcd->cols];
+    for (col = 0; col < lcd->cols; col++) {
+        if (lcd->line[col] == shadow[col]) {
+            continue;
+        }
+        if ((lcd->row == row) && (col >= lcd->col) &&
+            ((col - lcd->col) < SPE_LCD_MOVE_COST)) {
+            /* Cheaper to write the unchanged cells again than to move */
+            for (; lcd->col < col; lcd->col++) {
+                lcd->putc(shadow[lcd->col]);
+                sent++;
+            }
+        } else if ((lcd->row != row) || (lcd->col != col)) {
+            lcd->move(row, col);
+            sent++;
+        }
+        lcd->putc(lcd->line[col]);
+        shadow[col] = lcd->line[col];
+        lcd->row = row;
+        lcd->col = col + 1;
+        sent++;
+    }
+
+    return sent;
+} /* spe_lcd_vprintf */
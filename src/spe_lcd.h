@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_LCD_H
+#define SPE_LCD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stddef.h> /* size_t */
+
+#include "spe_printf.h"
+
+/**
+ * Characters an unchanged cell may cost before moving the cursor past it
+ * is cheaper than writing it again. A cursor move is one command on a
+ * HD44780 bus, as expensive as one character. Increase it if the move
+ * hook is more expensive than that.
+ */
+#ifndef SPE_LCD_MOVE_COST
+#define SPE_LCD_MOVE_COST 1
+#endif
+
+/**
+ * Character display with a shadow of its contents. Use macro SPE_LCD_SETUP
+ * for initialisation.\n
+ * Don't modify directly.
+ */
+struct spe_lcd {
+    char *shadow;                       /*!< What the display shows,
+                                             rows * cols */
+    char *line;                         /*!< Staging buffer, cols + 1 */
+    int rows;                           /*!< Number of rows */
+    int cols;                           /*!< Number of columns */
+    void (*move)(int row, int col);     /*!< Move the cursor */
+    void (*putc)(char c);               /*!< Write at the cursor, which
+                                             then moves one step right */
+    int row;                            /*!< Cursor row, -1 if unknown */
+    int col;                            /*!< Cursor column */
+#ifdef USE_TIMESTAMP
+    struct spe_time_cache tcache;       /*!< %pT cache of line */
+#endif
+};
+
+/**
+ * Set up a display from a shadow array of rows * cols characters, a line
+ * array of cols + 1 characters and the two hooks.
+ */
+#define SPE_LCD_SETUP(shadow_array, line_array, move_fn, putc_fn)      \
+    {                                                                  \
+        .shadow = shadow_array,                                        \
+        .line = line_array,                                            \
+        .rows = (int)(sizeof(shadow_array) /                           \
+                      (sizeof(line_array) - 1)),                       \
+        .cols = (int)(sizeof(line_array) - 1),                         \
+        .move = move_fn,                                               \
+        .putc = putc_fn,                                               \
+        .row = -1,                                                     \
+        .col = 0,                                                      \
+        SPE_TIME_CACHE_SETUP                                           \
+    }
+
+void spe_lcd_invalidate(struct spe_lcd *lcd);
+int spe_lcd_printf(struct spe_lcd *lcd, int row, const char *fmt, ...)
+    __attribute__((__format__(__printf__, 3, 4)));
+int spe_lcd_vprintf(struct spe_lcd *lcd, int row, const char *fmt,
+                    va_list ap)
+    __attribute__((__format__(__printf__, 3, 0)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_LCD_H */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_log.c
+ *
+ * Leveled logging on top of spe_printf.
+ *
+ * Lines are written with SPE_LOG_ERROR(), SPE_LOG_WARN(), SPE_LOG_INFO()
+ * and SPE_LOG_DEBUG(), giving a module defined by SPE_LOG_MODULE_DEFINE().
+ * There are two filters:
+ * \li SPE_LOG_MAX_LEVEL removes lines above it at compile time. They leave
+ * neither code nor format strings in the image.
+ * \li The level of the module is checked at runtime, inline at the call
+ * site, before the arguments are evaluated.
+ *
+ * \code
+ * SPE_LOG_MODULE_DEFINE(radio, SPE_LOG_LEVEL_INFO);
+ *
+ * SPE_LOG_INFO(radio, "rssi %d", read_rssi());
+ * SPE_LOG_DEBUG(radio, "state %d", state);
+ * \endcode
+ *
+ * The debug line is not printed, and its arguments are not evaluated.
+ *
+ * Lines go to spe_stdout, unless another file descriptor or a tee is set.
+ * A tee gets SPE_LOG_MASK() of the level as severity, so its sinks can
+ * pick levels, for instance only errors and warnings to a crash log.
+ */
+
+#include <stdarg.h>
+
+#include "spe_log.h"
+
+static SPE_FILE *log_fd = NULL;
+static struct spe_tee *log_tee = NULL;
+
+
+/**
+ * \b spe_log_set_output
+ *
+ * Print log lines to fd. Replaces any tee set.
+ *
+ * @param fd A pointer to the file descriptor, NULL for spe_stdout.
+ */
+void
+spe_log_set_output(SPE_FILE *fd)
+{
+    log_fd = fd;
+    log_tee = NULL;
+} /* spe_log_set_output */
+
+
+/**
+ * \b spe_log_set_tee
+ *
+ * Print log lines to the sinks of tee, with the severity SPE_LOG_MASK() of
+ * their level. Replaces any file descriptor set.
+ *
+ * @param tee The tee, NULL for spe_stdout.
+ */
+void
+spe_log_set_tee(struct spe_tee *tee)
+{
+    log_tee = tee;
+    log_fd = NULL;
+} /* spe_log_set_tee */
+
+
+/**
+ * \b spe_log_printf
+ *
+ * Print a log line. Normally called by the SPE_LOG_* macros, which have
+ * already checked the level against the module.
+ *
+ * @param level Level of the line, SPE_LOG_LEVEL_*.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int
+spe_log_printf(int level, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    if (log_tee) {
+        returned = spe_tee_vprintf(log_tee, SPE_LOG_MASK(level), fmt, ap);
+    } else {
+        returned = spe_vfprintf(log_fd ? log_fd : spe_stdout, fmt, ap);
+    }
+    va_end(ap);
+
+    return returned;
+} /* spe_log_printf */
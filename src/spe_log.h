@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_LOG_H
+#define SPE_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "spe_printf.h"
+#include "spe_tee.h"
+
+/**
+ * Log levels. A line is printed if its level is at most the level of its
+ * module, and it is compiled in if it is at most SPE_LOG_MAX_LEVEL.
+ */
+#define SPE_LOG_LEVEL_NONE  0 /*!< Nothing */
+#define SPE_LOG_LEVEL_ERROR 1 /*!< Errors */
+#define SPE_LOG_LEVEL_WARN  2 /*!< Warnings and errors */
+#define SPE_LOG_LEVEL_INFO  3 /*!< Information, warnings and errors */
+#define SPE_LOG_LEVEL_DEBUG 4 /*!< Everything */
+
+/**
+ * Highest level compiled in. Lines above it are removed by the
+ * preprocessor together with their format strings and arguments. Define
+ * it, for instance with ``CFLAGS += -DSPE_LOG_MAX_LEVEL=2``, for a smaller
+ * image.
+ */
+#ifndef SPE_LOG_MAX_LEVEL
+#define SPE_LOG_MAX_LEVEL SPE_LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * Severity of a level, as given to the sinks of a tee. See spe_log_set_tee().
+ */
+#define SPE_LOG_MASK(level) (1U << (level))
+
+/**
+ * A log module with its runtime level. Use SPE_LOG_MODULE_DEFINE for
+ * definition and SPE_LOG_MODULE_DECLARE in other files using it.
+ */
+struct spe_log_module {
+    const char *name; /*!< Printed in front of every line */
+    int level;        /*!< Highest level printed, see SPE_LOG_SET_LEVEL */
+};
+
+#define SPE_LOG_MODULE_DEFINE(mod, lvl)                         \
+    struct spe_log_module spe_log_module_##mod = { #mod, lvl }
+#define SPE_LOG_MODULE_DECLARE(mod)                     \
+    extern struct spe_log_module spe_log_module_##mod
+
+/**
+ * Change the level of a module at runtime.
+ */
+#define SPE_LOG_SET_LEVEL(mod, lvl) (spe_log_module_##mod.level = (lvl))
+
+/**
+ * Print a line if the module level allows it. The level check is done
+ * before spe_log_printf() is called, so the arguments are not evaluated
+ * and no va_list is set up for lines not printed. The line is prefixed by
+ * the level letter and the module name, and a newline is added.
+ */
+#define SPE_LOG(mod, lvl, letter, fmt, ...)                             \
+    do {                                                                \
+        if ((lvl) <= spe_log_module_##mod.level) {                      \
+            spe_log_printf(lvl, letter "/%s: " fmt "\n",                \
+                           spe_log_module_##mod.name, ##__VA_ARGS__);   \
+        }                                                               \
+    } while (0)
+
+#if SPE_LOG_MAX_LEVEL >= SPE_LOG_LEVEL_ERROR
+#define SPE_LOG_ERROR(mod, fmt, ...)                                    \
+    SPE_LOG(mod, SPE_LOG_LEVEL_ERROR, "E", fmt, ##__VA_ARGS__)
+#else
+#define SPE_LOG_ERROR(mod, fmt, ...) ((void)0)
+#endif
+
+#if SPE_LOG_MAX_LEVEL >= SPE_LOG_LEVEL_WARN
+#define SPE_LOG_WARN(mod, fmt, ...)                                     \
+    SPE_LOG(mod, SPE_LOG_LEVEL_WARN, "W", fmt, ##__VA_ARGS__)
+#else
+#define SPE_LOG_WARN(mod, fmt, ...) ((void)0)
+#endif
+
+#if SPE_LOG_MAX_LEVEL >= SPE_LOG_LEVEL_INFO
+#define SPE_LOG_INFO(mod, fmt, ...)                                     \
+    SPE_LOG(mod, SPE_LOG_LEVEL_INFO, "I", fmt, ##__VA_ARGS__)
+#else
+#define SPE_LOG_INFO(mod, fmt, ...) ((void)0)
+#endif
+
+#if SPE_LOG_MAX_LEVEL >= SPE_LOG_LEVEL_DEBUG
+#define SPE_LOG_DEBUG(mod, fmt, ...)                                    \
+    SPE_LOG(mod, SPE_LOG_LEVEL_DEBUG, "D", fmt, ##__VA_ARGS__)
+#else
+#define SPE_LOG_DEBUG(mod, fmt, ...) ((void)0)
+#endif
+
+void spe_log_set_output(SPE_FILE *fd);
+void spe_log_set_tee(struct spe_tee *tee);
+int spe_log_printf(int level, const char *fmt, ...)
+    __attribute__((__format__(__printf__, 2, 3)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_LOG_H */
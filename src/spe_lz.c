@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_lz.c
+ *
+ * Compressing sink for logs stored in flash.
+ *
+ * Characters are collected into a block, and a full block is compressed
+ * with LZSS and handed to the write hook, which typically programs it
+ * into flash. Log text repeats itself a lot, timestamps, module names and
+ * whole phrases, so a block of log lines usually shrinks to less than
+ * half. Matches never reach outside their block, which makes every block
+ * possible to decompress on its own, after a power loss or when the
+ * oldest blocks of a ring have been erased.
+ *
+ * \code
+ * static char flash_in[512];
+ * static unsigned char flash_out[SPE_LZ_OUT_SIZE(sizeof(flash_in))];
+ * static struct spe_lz flash_lz = SPE_LZ_SETUP(flash_in, flash_out,
+ *                                              flash_append);
+ *
+ * static void
+ * flash_putc(char c)
+ * {
+ *     spe_lz_putc(&flash_lz, c);
+ * }
+ *
+ * SPE_FILE flash_log = SPE_PRINTF_SETUP(flash_putc);
+ * \endcode
+ *
+ * Call spe_lz_flush() before power down to write a partly filled block.
+ * All RAM used is the two arrays and the hash table within struct spe_lz,
+ * compressing a block takes time linear in its length.
+ *
+ * Each block starts with a header of SPE_LZ_HEADER bytes
+ *
+ * - 'Z' for a compressed block or 'S' for a block stored as is, since
+ *   compressing it didn't make it smaller. Erased (0xff) or zeroed flash
+ *   is neither, which marks the end of the log.
+ * - The number of characters in the block, 16 bits little endian.
+ * - The number of bytes after the header, 16 bits little endian.
+ *
+ * A compressed block is a sequence of groups of a flag byte followed by
+ * up to eight items, one per flag bit from the least significant one. A
+ * clear bit is a literal byte, a set bit a match of two bytes, the upper
+ * four bits of the first byte being the length minus 3 and the remaining
+ * twelve bits the distance back minus 1. The same format is decoded by
+ * spe_lz_decode() and by tools/spe_lz_decode.py on the host.
+ */
+
+#include <string.h>
+
+#include "spe_lz.h"
+
+#define MIN_MATCH 3
+#define MAX_MATCH (MIN_MATCH + 15)
+
+
+/**
+ * \b hash3
+ *
+ * Hash of the three characters at str, for finding earlier occurences.
+ * This is an internal function not for use by application code.
+ *
+ * @param str Three characters.
+ *
+ * @retval Index into the hash table.
+ */
+static unsigned int
+hash3(const char *str)
+{
+    unsigned long v = ((unsigned long)(unsigned char)str[0] << 16) |
+        ((unsigned long)(unsigned char)str[1] << 8) |
+        (unsigned long)(unsigned char)str[2];
+
+    return (unsigned int)(((v * 2654435761UL) & 0xffffffffUL) >>
+                          (32 - SPE_LZ_HASH_BITS));
+} /* hash3 */
+
+
+/**
+ * \b compress_block
+ *
+ * Compress the collected characters after the header in the output array.
+ * This is an internal function not for use by application code.
+ *
+ * @param lz The sink.
+ *
+ * @retval >0 Number of compressed bytes.
+ * @retval 0 Compressing didn't make the block smaller.
+ */
+static size_t
+compress_block(struct spe_lz *lz)
+{
+    const char *in = lz->in;
+    unsigned char *out = &lz->out[SPE_LZ_HEADER];
+    size_t len = lz->len;
+    size_t pos = 0;
+    size_t used = 0;
+    size_t flags = 0;
+    unsigned int bit = 8;
+
+    memset(lz->hash, 0, sizeof(lz->hash));
+    while (pos < len) {
+        size_t match = 0;
+        size_t distance = 0;
+
+        if (bit == 8) {
+            if (used + 1 >= len) {
+                return 0;
+            }
+            flags = used++;
+            out[flags] = 0;
+            bit = 0;
+        }
+
+        if (pos + MIN_MATCH <= len) {
+            unsigned int h = hash3(&in[pos]);
+            size_t earlier = lz->hash[h];
+
+            /* Stored plus one, 0 is an empty slot */
+            lz->hash[h] = (unsigned short)(pos + 1);
+            if (earlier) {
+                earlier--;
+                distance = pos - earlier;
+                while ((distance <= SPE_LZ_MAX_BLOCK) &&
+                       (match < MAX_MATCH) && (pos + match < len) &&
+                       (in[earlier + match] == in[pos + match])) {
+                    match++;
+                }
+            }
+        }
+
+        if (match >= MIN_MATCH) {
+            size_t end = pos + match;
+
+            if (used + 2 >= len) {
+                return 0;
+            }
+            out[flags] |= (unsigned char)(1U << bit);
+            out[used++] = (unsigned char)(((match - MIN_MATCH) << 4) |
+                                          ((distance - 1) >> 8));
+            out[used++] = (unsigned char)((distance - 1) & 0xff);
+            /* Later matches may start within this one */
+            for (pos++; pos < end; pos++) {
+                if (pos + MIN_MATCH <= len) {
+                    lz->hash[hash3(&in[pos])] = (unsigned short)(pos + 1);
+                }
+            }
+        } else {
+            if (used + 1 >= len) {
+                return 0;
+            }
+            out[used++] = (unsigned char)in[pos++];
+        }
+        bit++;
+    }
+
+    return used;
+} /* compress_block */
+
+
+/**
+ * \b spe_lz_putc
+ *
+ * Add a character, compressing and writing the block when it is full.
+ *
+ * @param lz The sink.
+ * @param c Character to add.
+ */
+void
+spe_lz_putc(struct spe_lz *lz, char c)
+{
+    lz->in[lz->len++] = c;
+    if (lz->len >= lz->size) {
+        spe_lz_flush(lz);
+    }
+} /* spe_lz_putc */
+
+
+/**
+ * \b spe_lz_flush
+ *
+ * Compress and write the characters collected so far as a block of its
+ * own. Does nothing if there are none.
+ *
+ * @param lz The sink.
+ */
+void
+spe_lz_flush(struct spe_lz *lz)
+{
+    size_t len = lz->len;
+    size_t payload;
+
+    if (!len) {
+        return;
+    }
+    payload = compress_block(lz);
+    if (payload) {
+        lz->out[0] = 'Z';
+    } else {
+        lz->out[0] = 'S';
+        memcpy(&lz->out[SPE_LZ_HEADER], lz->in, len);
+        payload = len;
+    }
+    lz->out[1] = (unsigned char)(len & 0xff);
+    lz->out[2] = (unsigned char)(len >> 8);
+    lz->out[3] = (unsigned char)(payload & 0xff);
+    lz->out[4] = (unsigned char)(payload >> 8);
+    lz->len = 0;
+
+    lz->write(lz->out, SPE_LZ_HEADER + payload);
+} /* spe_lz_flush */
+
+
+/**
+ * \b spe_lz_decode
+ *
+ * Decompress one block written by spe_lz_flush().
+ *
+ * @param block Start of the block.
+ * @param len Bytes available from block on.
+ * @param out Where to put the characters of the block.
+ * @param size Size of out.
+ * @param used Set to the size of the block, for finding the next one.
+ *             May be NULL.
+ *
+ * @retval >=0 Number of characters in out, not terminated.
+ * @retval -1 On the end of the log, a damaged block or if out is too small.
+ */
+long
+spe_lz_decode(const unsigned char *block, size_t len, char *out,
+              size_t size, size_t *used)
+{
+    size_t raw, end;
+    size_t i = SPE_LZ_HEADER;
+    size_t o = 0;
+
+    if (len < SPE_LZ_HEADER) {
+        return -1;
+    }
+    raw = (size_t)block[1] | ((size_t)block[2] << 8);
+    end = SPE_LZ_HEADER + ((size_t)block[3] | ((size_t)block[4] << 8));
+    if ((end > len) || (raw > size)) {
+        return -1;
+    }
+
+    if (block[0] == 'S') {
+        if (end - SPE_LZ_HEADER != raw) {
+            return -1;
+        }
+        memcpy(out, &block[SPE_LZ_HEADER], raw);
+        o = raw;
+    } else if (block[0] == 'Z') {
+        while (o < raw) {
+            unsigned int flags;
+            unsigned int bit;
+
+            if (i >= end) {
+                return -1;
+            }
+            flags = block[i++];
+            for (bit = 0; (bit < 8) && (o < raw); bit++) {
+                if (flags & (1U << bit)) {
+                    size_t match, distance;
+
+                    if (i + 2 > end) {
+                        return -1;
+                    }
+                    match = (size_t)(block[i] >> 4) + MIN_MATCH;
+                    distance = ((((size_t)block[i] & 0x0f) << 8) |
+                                (size_t)block[i + 1]) + 1;
+                    i += 2;
+                    if ((distance > o) || (o + match > raw)) {
+                        return -1;
+                    }
+                    /* Byte by byte, the match may overlap itself */
+                    for (; match; match--, o++) {
+                        out[o] = out[o - distance];
+                    }
+                } else {
+                    if (i >= end) {
+                        return -1;
+                    }
+                    out[o++] = (char)block[i++];
+                }
+            }
+        }
+        if (i != end) {
+            return -1;
+        }
+    } else {
+        return -1;
+    }
+
+    if (used) {
+        *used = end;
+    }
+    return (long)o;
+} /* spe_lz_decode */
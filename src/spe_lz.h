@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_LZ_H
+#define SPE_LZ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h> /* size_t */
+
+/**
+ * Bits of the match finder hash, the table takes 2 << SPE_LZ_HASH_BITS
+ * bytes of RAM within struct spe_lz. More bits find more matches.
+ */
+#ifndef SPE_LZ_HASH_BITS
+#define SPE_LZ_HASH_BITS 8
+#endif
+
+/** Bytes in front of every block, see spe_lz.c for the format */
+#define SPE_LZ_HEADER 5
+
+/** Largest block, matches reach at most this far back */
+#define SPE_LZ_MAX_BLOCK 4096
+
+/** Size of the output array for blocks of block_size characters */
+#define SPE_LZ_OUT_SIZE(block_size) ((block_size) + SPE_LZ_HEADER)
+
+/**
+ * Compressing sink. Use macro SPE_LZ_SETUP for initialisation.\n
+ * Don't modify directly.
+ */
+struct spe_lz {
+    char *in;                           /*!< Block being collected */
+    unsigned char *out;                 /*!< Block being compressed */
+    size_t size;                        /*!< Size of a block */
+    size_t len;                         /*!< Characters in the block */
+    void (*write)(const unsigned char *block, size_t len); /*!< Storage */
+    unsigned short hash[1 << SPE_LZ_HASH_BITS]; /*!< Match finder */
+};
+
+/**
+ * 0, or a compile error if cond is false. For checks within an
+ * initialiser, where a declaration can't go.
+ */
+#define SPE_LZ_CHECK(cond) (0 * sizeof(char[(cond) ? 1 : -1]))
+
+/**
+ * Set up a compressing sink from an input array of at most
+ * SPE_LZ_MAX_BLOCK characters, an output array of
+ * SPE_LZ_OUT_SIZE(sizeof(in_array)) bytes and a function writing each
+ * compressed block to storage. Arrays of other sizes don't compile, since
+ * the block header, the hash table and the match distances only reach
+ * SPE_LZ_MAX_BLOCK.
+ */
+#define SPE_LZ_SETUP(in_array, out_array, write_fn)                    \
+    {                                                                  \
+        .in = in_array,                                                \
+        .out = out_array,                                              \
+        .size = sizeof(in_array) +                                     \
+            SPE_LZ_CHECK(sizeof(in_array) <= SPE_LZ_MAX_BLOCK) +       \
+            SPE_LZ_CHECK(sizeof(out_array) >=                          \
+                         SPE_LZ_OUT_SIZE(sizeof(in_array))),           \
+        .len = 0,                                                      \
+        .write = write_fn,                                             \
+        .hash = { 0 },                                                 \
+    }
+
+void spe_lz_putc(struct spe_lz *lz, char c);
+void spe_lz_flush(struct spe_lz *lz);
+long spe_lz_decode(const unsigned char *block, size_t len, char *out,
+                   size_t size, size_t *used);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_LZ_H */
@@ -32,7 +32,10 @@
  * It is implemented with the notion of file descriptors. Since no state is
  * kept between calls, the functions are considered reentrant. That is valid
  * as long as the callback to output character by character is reentrant
- * (or protected by mutexes).
+ * (or protected by mutexes). The exception is `%%pT` with USE_TIMESTAMP,
+ * which caches the date and hour in the file descriptor. `%%pT` on one file
+ * descriptor is not reentrant, give an interrupt handler and each task
+ * their own file descriptor, or protect it, if they all print timestamps.
  *
  * There is a need for startup initialization per file descriptor to
  * register a callback function to output one single character at a time.
@@ -51,13 +54,39 @@
  * \li d: prints out a signed integer variable in decimal format.
  * \li u: prints out an unsigned integer variable in decimal format.
  * \li x: prints out an unsigned integer variable in hexadecimal format.
+ * \li X: as x, with upper case digits.
+ * \li o: prints out an unsigned integer variable in octal format.
+ * \li b: prints out an unsigned integer variable in binary format.
+ * \li p: prints out a pointer in hexadecimal format, or `(nil)`.
  * \li f: prints out floating point number, if compiled in. Compile with
  * ``CFLAGS += -DUSE_DOUBLE`` as argument to compiler.
+ * \li pT: prints out a timestamp in ISO-8601 UTC, if compiled in. Takes a
+ * pointer to an `unsigned long long` with time since epoch. Followed by the
+ * unit: `%%pTs` for seconds, `%%pTm` for milliseconds and `%%pTu` for
+ * microseconds, for instance 2021-03-04T05:06:07.890Z. Compile with
+ * ``CFLAGS += -DUSE_TIMESTAMP`` as argument to compiler.
+ * \li pD: prints out a duration as hours, minutes and seconds, for instance
+ * 123:04:05.678. Same argument and units as pT.
+ * \li pQ: prints out a string within double quotes, escaped as a C string
+ * literal, if compiled in. `%%pJ` escapes it as a JSON string instead.
+ * Compile with ``CFLAGS += -DUSE_QUOTED`` as argument to compiler.
+ * \li pB: prints out binary data as base64, if compiled in. The number of
+ * bytes is the width, `%%*pB` with the length before the pointer.
+ * `%%*pA` prints base85 with the Z85 alphabet instead. Compile with
+ * ``CFLAGS += -DUSE_BLOB`` as argument to compiler.
+ * \li pW: prints out a 128 bit unsigned integer in decimal, if compiled in.
+ * Takes a pointer to a struct spe_u128, or to an `unsigned __int128` on a
+ * little endian target. `%%pWd` prints it as signed. Compile with
+ * ``CFLAGS += -DUSE_BIGINT`` as argument to compiler.
+ * \li p followed by a registered character: prints out the pointed to
+ * argument with a custom conversion, if compiled in. Compile with
+ * ``CFLAGS += -DUSE_CUSTOM_CONVERSION`` and see spe_register_conversion().
  *
  * \subsection conversion_tags_optional Optional
  *
- * The `l` modifier can be used with signed, unsigned and hexadecimal
- * conversion tags to print out `long` variables (`%%lu`, `%%ld` and `%%lx`).
+ * The `l` modifier can be used with signed, unsigned, hexadecimal, octal and
+ * binary conversion tags to print out `long` variables (`%%lu`, `%%ld` and
+ * `%%lx`).
  *
  * \section printf_variants Variants of the printf routines
  *
@@ -67,6 +96,119 @@
  * \li The variadic group contains spe_vprintf() and spe_vfprintf()
  * (see https://en.wikipedia.org/wiki/Variadic_function)
  *
+ * \section custom_conversions Custom conversions
+ *
+ * Values such as IPv4 or MAC addresses can be printed straight into the
+ * file descriptor instead of being formatted into a temporary string first.
+ * spe_register_conversion() maps a character to a callback, which is then
+ * used as %p followed by that character, looked up in a table indexed by the
+ * character. The callback writes with spe_fputc(), spe_fputs() or
+ * spe_fprintf() and may consume more characters of the format string:
+ * \code
+ * static int
+ * print_ipv4(SPE_FILE *fd, const struct spe_conv_spec *spec, const void *arg)
+ * {
+ *     const unsigned char *ip = arg;
+ *     (void)spec;
+ *     spe_fprintf(fd, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+ *     return 0;
+ * }
+ *
+ * spe_register_conversion('I', print_ipv4);
+ * spe_printf("Address %pI\n", addr);
+ * \endcode
+ *
+ * \section timestamp_cache Timestamp cache
+ *
+ * The date and hour of the last timestamp printed is cached in the file
+ * descriptor. Log lines within the same hour then only convert minutes,
+ * seconds and fraction, instead of doing the calendar calculation again.
+ * USE_TIMESTAMP changes the layout of struct spe_fd and must therefore be
+ * defined the same way for the library and the application.
+ *
+ * \section saturation Bounded strings
+ *
+ * Once a character doesn't fit in the string of spe_snprintf() the file
+ * descriptor is marked as full. The rest of the format string and its arguments are then
+ * skipped instead of being converted character by character only to be
+ * dropped, which also means that errors in the skipped part are not
+ * reported. A size of 0 leaves the string untouched.
+ *
+ * Integers printed to a string have their whole field length computed
+ * first. If it fits, the field is written straight into the string with
+ * the digits written backwards, so there is one bounds check per field
+ * instead of one per character. Otherwise, and for callbacks, the digits
+ * go one by one through the same path as all other characters.
+ *
+ * Text between conversions and strings printed with %s are copied a run at
+ * a time. The kind of file descriptor is checked once per run, so a string
+ * gets a copy loop with a single bound and a callback is called in a loop
+ * without the string checks of print_char().
+ *
+ * \section arg_pack Argument packs
+ *
+ * With USE_ARG_PACK set, spe_fprintf_args() and spe_snprintf_args() take
+ * the arguments from an array of struct spe_arg instead of a va_list. A
+ * va_list can only be walked once and not kept beyond its call, a pack can
+ * be rendered again to other file descriptors or with other formats, or
+ * stored and rendered later:
+ * \code
+ * const struct spe_arg args[] = {
+ *     SPE_ARG_U64(now_us), SPE_ARG_STRING("radio"), SPE_ARG_INT(rssi),
+ * };
+ * spe_fprintf_args(uart, "%pTu %s: %d dBm\n", args, 3);
+ * \endcode
+ * Every argument is checked against its conversion, and a missing or
+ * mistyped one fails the call. Timestamps are given by value, so nothing
+ * needs to stay valid for them. Both sources share the same conversions,
+ * only the fetching of each argument differs.
+ *
+ * \section quoted Quoted strings
+ *
+ * `%%pQ` and `%%pJ` print a string as a C string literal or a JSON string,
+ * quotes included, so strings from users or the network can go into logs
+ * and JSON without a temporary escaped copy. Most characters of a typical
+ * string need no escape. The string is scanned eight characters at a time
+ * for the ones that do, and the runs in between are copied in one go,
+ * with memcpy() to a string.
+ *
+ * \section blob Binary data
+ *
+ * `%%*pB` and `%%*pA` print the bytes at a pointer as base64 or base85,
+ * taking the number of bytes as width, so a blob goes into a text line
+ * in one conversion instead of a `%%02x` per byte. Base64 is 4 characters
+ * per 3 bytes and base85 5 per 4, against 6 per 3 for hex. Groups of bytes
+ * are encoded by table lookups into a small chunk on the stack, which is
+ * printed in one go, with memcpy() to a string.
+ *
+ * \section bigint Big integers
+ *
+ * `%%pW` and spe_fput_bigint() print integers wider than unsigned long.
+ * Dividing the whole number by ten for every digit would take a division
+ * per limb and digit. Instead each pass divides by the largest power of
+ * ten that fits in half an unsigned long, 10^9 or 10^4, which gives that
+ * many digits at once. The divisions are by a constant of the width of
+ * unsigned long, which compilers turn into a multiplication by the
+ * reciprocal, and the digits within a chunk are then ordinary 32 or 64
+ * bit arithmetic.
+ *
+ * \section utf8 UTF-8 text
+ *
+ * With USE_UTF8 the precision of `%%.Ns` is a number of code points, and
+ * the string is cut before the first character that does not fit, never
+ * inside one. Eight bytes are tested for ASCII at once, so only the non
+ * ASCII characters are decoded one by one. `%%ls` and `%%lc` encode wide
+ * characters to UTF-8 on the fly into a small chunk on the stack. The
+ * precision of `%%.Nls` is a number of bytes, as in C99.
+ *
+ * \section fingerprint Fingerprints
+ *
+ * spe_vfingerprint() hashes a format string and its arguments into what
+ * is the same for the same line, without formatting any number. Strings
+ * are hashed by their characters, timestamps are left out. spe_repeat.c
+ * uses it to recognise repeated lines before formatting them. Compile with
+ * ``CFLAGS += -DUSE_FINGERPRINT`` as argument to compiler.
+ *
  * \section supported What is supported and what is not supported
  *
  * To understand what *minimal width* and *precision* are, see: \n
@@ -76,21 +218,56 @@
  * \subsection supported_supported Supported
  * \li All conversion tags above.
  * \li Minimal width and optional precision for all numerical types.
- * \li Reentrance (of course if callback is reentrant).
+ * \li Minimal width and precision as a parameter to the conversion (`*`).
+ * \li The `0` flag, padding numerical types with zeros.
+ * \li The `#` flag, adding `0x`, `0X` or `0b` to non-zero x, X and b.
+ * \li Reentrance (of course if callback is reentrant), except for `%%pT`
+ *     on a shared file descriptor.
  *
  * \subsection supported_unsupported Unsupported
- * \li minimal width and optional precision for strings.
- * \li negative minimal width (left adjustment).
- * \li minimal width as a parameter to the conversion string.
+ * \li minimal width for strings, and precision unless USE_UTF8 is defined.
+ * \li negative minimal width (left adjustment), also as a parameter.
+ * \li The `-`, `+` and space flags, which make the conversion fail.
+ * \li The `#` flag is accepted, but ignored, for octal.
+ *
+ * \section parser Conversion parser
+ *
+ * Everything between % and the conversion character is parsed by a small
+ * state machine. Each character is classified by a lookup table, and the
+ * next state is a second lookup on state and class, so there is only one
+ * branch per character. The parsed specification is also what custom
+ * conversions get, see struct spe_conv_spec.
  */
 
 /**
  * \file
  */
+#include <limits.h>
 #include <stdarg.h>
+#if defined(USE_QUOTED) || defined(USE_UTF8)
+#include <stdint.h>
+#endif
+#include <string.h>
+#ifdef USE_UTF8
+#include <wchar.h>
+#endif
 
 #include "spe_printf.h"
 
+/* Anything following %p besides plain pointers */
+#if defined(USE_TIMESTAMP) || defined(USE_CUSTOM_CONVERSION) || \
+    defined(USE_QUOTED) || defined(USE_BLOB) || defined(USE_BIGINT)
+#define POINTER_EXTENSIONS
+#endif
+
+#if (defined(USE_QUOTED) || defined(USE_UTF8)) && \
+    defined(__BYTE_ORDER__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SPE_SWAR
+#define ONES  0x0101010101010101ULL /* 1 in every byte */
+#define HIGHS 0x8080808080808080ULL /* Top bit of every byte */
+#endif
+
 static const char tohex_lc[] = "0123456789abcdef";
 static const char tohex_uc[] = "0123456789ABCDEF";
 
@@ -98,6 +275,8 @@ enum base_t {
     BASE_DECIMAL,
     BASE_HEX_UPPER_CASE,
     BASE_HEX_LOWER_CASE,
+    BASE_OCTAL,
+    BASE_BINARY,
 };
 
 static void
@@ -109,81 +288,278 @@ print_char(SPE_FILE *fd, const char c)
     if (fd->str) {
         if (fd->curr < (fd->max - 1)) {
             fd->str[fd->curr++] = c;
+        } else if (!fd->putc) {
+            fd->full = 1;
         }
     }
 } /* print_char */
 
 /**
- * \b print_uil
+ * \b print_pad
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print what goes in front of the digits of a number. Precision is the
+ * minimum number of digits, filled out with zeros. Minimal width is the
+ * whole field including prefix, filled out with spaces in front of
+ * everything.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param min_width Minimum field width.
+ * @param precision Minimum number of digits to represent the integer.
+ * @param nuf_digits Number of digits of the integer.
+ * @param prefix Minus sign or 0x to print before the zeros, or NULL.
+ */
+static void
+print_pad(SPE_FILE *fd, int min_width, int precision, const int nuf_digits,
+          const char *prefix)
+{
+    int i;
+
+    if (precision < nuf_digits) {
+        precision = nuf_digits;
+    }
+    min_width -= precision;
+    for (i = 0; prefix && prefix[i]; i++) {
+        min_width--;
+    }
+    for (; (min_width > 0) && !fd->full; min_width--) {
+        print_char(fd, ' ');
+    }
+    for (i = 0; prefix && prefix[i]; i++) {
+        print_char(fd, prefix[i]);
+    }
+    for (; (precision > nuf_digits) && !fd->full; precision--) {
+        print_char(fd, '0');
+    }
+} /* print_pad */
+
+/**
+ * \b reserve_field
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Reserve room for a whole integer field in the string of fd and write
+ * what goes in front of the digits, the same way as print_pad(). The
+ * caller then writes the digits backwards from the returned pointer. One
+ * bounds check for the field replaces the one print_char() does for every
+ * character. Only for file descriptors without callback.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param min_width Minimum field width.
+ * @param precision Minimum number of digits to represent the integer.
+ * @param nuf_digits Number of digits of the integer.
+ * @param prefix Minus sign or 0x to print before the zeros, or NULL.
+ *
+ * @retval Pointer just past the last digit.
+ * @retval NULL if fd has a callback or the field does not fit.
+ */
+static char *
+reserve_field(SPE_FILE *fd, int min_width, int precision,
+              const int nuf_digits, const char *prefix)
+{
+    int prefix_len = 0;
+    int len;
+    char *p;
+
+    if (fd->putc || !fd->str) {
+        return NULL;
+    }
+    while (prefix && prefix[prefix_len]) {
+        prefix_len++;
+    }
+    if (precision < nuf_digits) {
+        precision = nuf_digits;
+    }
+    len = (min_width > precision + prefix_len) ?
+        min_width : precision + prefix_len;
+    if ((size_t)len > (fd->max - 1) - fd->curr) {
+        return NULL;
+    }
+
+    p = &fd->str[fd->curr];
+    fd->curr += (size_t)len;
+    for (; min_width > precision + prefix_len; min_width--) {
+        *p++ = ' ';
+    }
+    while (prefix && *prefix) {
+        *p++ = *prefix++;
+    }
+    for (; precision > nuf_digits; precision--) {
+        *p++ = '0';
+    }
+
+    return p + nuf_digits;
+} /* reserve_field */
+
+
+/**
+ * \b significant_bits
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Number of bits needed to represent number, 0 for 0. Counts leading zeros
+ * with a single instruction where the compiler has one.
+ *
+ * @param number The number to count bits in.
+ *
+ * @retval Number of significant bits.
+ */
+static int
+significant_bits(unsigned long number)
+{
+#ifdef __GNUC__
+    if (number == 0UL) {
+        return 0;
+    }
+    return (int)(sizeof(number) * 8U) - __builtin_clzl(number);
+#else
+    int bits = 0;
+
+    for (; number; number >>= 1) {
+        bits++;
+    }
+    return bits;
+#endif
+} /* significant_bits */
+
+
+/* Powers of ten that fit in an unsigned long, see decimal_digits() */
+static const unsigned long powers_of_ten[] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL,
+    100000000UL, 1000000000UL,
+#if ULONG_MAX > 0xffffffffUL
+    10000000000UL, 100000000000UL, 1000000000000UL, 10000000000000UL,
+    100000000000000UL, 1000000000000000UL, 10000000000000000UL,
+    100000000000000000UL, 1000000000000000000UL, 10000000000000000000UL,
+#endif
+};
+
+
+/**
+ * \b decimal_digits
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Number of decimal digits needed to represent number, at least 1. The
+ * number of significant bits times log10(2), approximated as 1233 / 4096,
+ * is the number of digits or one too many, which one power of ten
+ * comparison settles.
+ *
+ * @param number The number to count digits in.
+ *
+ * @retval Number of decimal digits.
+ */
+static int
+decimal_digits(unsigned long number)
+{
+    const int guess = (significant_bits(number) * 1233) >> 12;
+
+    if (number < powers_of_ten[guess]) {
+        return (guess == 0) ? 1 : guess;
+    }
+    return guess + 1;
+} /* decimal_digits */
+
+
+/**
+ * \b print_pow2
  *
  * This is an internal function not for use by application code.
  *
- * Print unsigned integer long to fd.
+ * Print unsigned integer long to fd in a base that is a power of two.
+ * The number of digits follows from the number of significant bits, and
+ * every digit is a shift and a mask, so no division is needed.
  *
  * @param fd Pointer to filedescriptor to output result to.
  * @param number The actual number to print out.
- * @param base Base to print out number in, see enum base_t.
+ * @param base Hexadecimal, octal or binary, see enum base_t.
  * @param min_width Minimum field width.
  * @param precision Minimum number of digits to represent the integer.
- * @param neg Non-zero if a minus sign should be added. Determined by the
-              conversion parser.
+ * @param prefix 0x or similar to print before the zeros, or NULL.
  * @retval 0 on success.
  * @retval -1 on failure.
  */
 static int
-print_uil(SPE_FILE *fd, unsigned long number, const enum base_t base,
-          int min_width, const int precision, int neg)
-{
-    unsigned long divider = 1UL;
-    int nuf_digits = 1;
-    unsigned long base_num = (base == BASE_DECIMAL) ? 10 : 16;
-
-    /* Find the biggest number dividable by base to use as starting
-       point for dividing down character by character*/
-    while ((number / divider) >= base_num) {
-        divider *= base_num;
-        nuf_digits++;
-        if (divider == 0L) {
-            return -1;
-        }
+print_pow2(SPE_FILE *fd, unsigned long number, const enum base_t base,
+           int min_width, int precision, const char *prefix)
+{
+    const int shift = (base == BASE_BINARY) ? 1 : (base == BASE_OCTAL) ? 3 : 4;
+    const unsigned long mask = (1UL << shift) - 1UL;
+    const char *digits = (base == BASE_HEX_UPPER_CASE) ? tohex_uc : tohex_lc;
+    int nuf_digits = (significant_bits(number) + shift - 1) / shift;
+    char *end;
+
+    if (nuf_digits == 0) {
+        nuf_digits = 1;
     }
 
-    /* We must make room for minus sign */
-    if (neg && (min_width > precision)) {
-        min_width -= 1;
+    end = reserve_field(fd, min_width, precision, nuf_digits, prefix);
+    if (end) {
+        /* Least significant digit first, written backwards */
+        for (; nuf_digits > 0; nuf_digits--) {
+            *--end = digits[number & mask];
+            number >>= shift;
+        }
+        return 0;
     }
 
-    /* Do the eventual fill out coming from minimal width and precision.
-       Before printing out any noticiable character, print out eventual minus.*/
-    while (nuf_digits < min_width) {
-        if (min_width <= precision) {
-            if (neg) {
-                neg = 0;
-                print_char(fd, '-');
-            }
-            print_char(fd, '0');
-        } else {
-            print_char(fd, ' ');
-        }
-        min_width--;
+    print_pad(fd, min_width, precision, nuf_digits, prefix);
+
+    /* Most significant digit first, shifted down to the lowest bits */
+    for (nuf_digits--; nuf_digits >= 0; nuf_digits--) {
+        print_char(fd, digits[(number >> (nuf_digits * shift)) & mask]);
     }
 
-    /* If we didn't print out any minus, do it now. */
-    if (neg) {
-        print_char(fd, '-');
+    return 0;
+} /* print_pow2 */
+
+
+/**
+ * \b print_uil
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print unsigned integer long to fd in decimal.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param number The actual number to print out.
+ * @param min_width Minimum field width.
+ * @param precision Minimum number of digits to represent the integer.
+ * @param neg Non-zero if a minus sign should be added. Determined by the
+              conversion parser.
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static int
+print_uil(SPE_FILE *fd, unsigned long number, int min_width, int precision,
+          const int neg)
+{
+    const int nuf_digits = decimal_digits(number);
+    char *end = reserve_field(fd, min_width, precision, nuf_digits,
+                              neg ? "-" : NULL);
+    /* The biggest power of ten not above number, used as starting
+       point for dividing down character by character */
+    unsigned long divider = powers_of_ten[nuf_digits - 1];
+
+    if (end) {
+        /* Least significant digit first, written backwards */
+        do {
+            *--end = (char)('0' + (number % 10U));
+            number /= 10U;
+        } while (number);
+        return 0;
     }
 
+    print_pad(fd, min_width, precision, nuf_digits, neg ? "-" : NULL);
+
     /* Print out character by character by using the divider we just found. */
     /* This is the secret sauce to this no-buffering print routine. */
     while (1) {
         unsigned long digit = number / divider;
-        if (base == BASE_HEX_LOWER_CASE) {
-            print_char(fd, tohex_lc[digit]);
-        } else {
-            print_char(fd, tohex_uc[digit]);
-        }
+        print_char(fd, (char)('0' + digit));
         number = number - (digit * divider);
-        divider /= base_num;
+        divider /= 10UL;
         if (divider == 0L) {
             break;
         }
@@ -201,7 +577,6 @@ print_uil(SPE_FILE *fd, unsigned long number, const enum base_t base,
  *
  * @param fd Pointer to filedescriptor to output result to.
  * @param number The actual number to print out.
- * @param base Base t print out number in, see enum base_t.
  * @param min_width Minimum field width.
  * @param precision Minimum number of digits to represent the integer.
  * @param neg Non-zero if a minus sign should be added. Determined by the
@@ -210,17 +585,19 @@ print_uil(SPE_FILE *fd, unsigned long number, const enum base_t base,
  * @retval -1 on failure.
  */
 static int
-print_sil(SPE_FILE *fd, signed long number, const enum base_t base,
-          const int min_width, const int precision)
+print_sil(SPE_FILE *fd, signed long number, const int min_width,
+          const int precision)
 {
+    unsigned long magnitude = (unsigned long)number;
     int neg = 0;
 
+    /* Negate as unsigned, -LONG_MIN does not fit in a long */
     if (number < 0L) {
         neg = 1;
-        number = -number;
+        magnitude = 0UL - magnitude;
     }
 
-    return print_uil(fd, (unsigned long)number, base, min_width, precision, neg);
+    return print_uil(fd, magnitude, min_width, precision, neg);
 } /* print_sil */
 
 
@@ -229,11 +606,10 @@ print_sil(SPE_FILE *fd, signed long number, const enum base_t base,
  *
  * This is an internal function not for use by application code.
  *
- * Print unsigned integer to fd.
+ * Print unsigned integer to fd in decimal.
  *
  * @param fd Pointer to filedescriptor to output result to.
  * @param number The actual number to print out.
- * @param base Base t print out number in, see enum base_t.
  * @param min_width Minimum field width.
  * @param precision Minimum number of digits to represent the integer.
  * @param neg Non-zero if a minus sign should be added. Determined by the
@@ -242,59 +618,34 @@ print_sil(SPE_FILE *fd, signed long number, const enum base_t base,
  * @retval -1 on failure.
  */
 static int
-print_ui(SPE_FILE *fd, unsigned int number, const enum base_t base,
-         int min_width, int precision, int neg)
-{
-    unsigned long divider = 1UL;
-    int nuf_digits = 1;
-    unsigned long base_num = (base == BASE_DECIMAL) ? 10 : 16;
-
-    /* Find the biggest number dividable by base to use as starting
-       point for dividing down character by character*/
-    while ((number / divider) >= base_num){
-        divider *= base_num;
-        nuf_digits++;
-        if (divider == 0L) {
-            return -1;
-        }
-    }
-
-    /* We must make room for minus sign */
-    if (neg && (min_width > precision)) {
-        min_width -= 1;
-    }
-
-    /* Do the eventual fill out coming from minimal width and precision.
-       Before printing out any noticiable character, print out eventual minus.*/
-    while (nuf_digits < min_width) {
-        if (min_width <= precision) {
-            if (neg) {
-                neg = 0;
-                print_char(fd, '-');
-            }
-            print_char(fd, '0');
-        } else {
-            print_char(fd, ' ');
-        }
-        min_width--;
+print_ui(SPE_FILE *fd, unsigned int number, int min_width, int precision,
+         const int neg)
+{
+    const int nuf_digits = decimal_digits(number);
+    char *end = reserve_field(fd, min_width, precision, nuf_digits,
+                              neg ? "-" : NULL);
+    /* The biggest power of ten not above number, used as starting
+       point for dividing down character by character */
+    unsigned long divider = powers_of_ten[nuf_digits - 1];
+
+    if (end) {
+        /* Least significant digit first, written backwards */
+        do {
+            *--end = (char)('0' + (number % 10U));
+            number /= 10U;
+        } while (number);
+        return 0;
     }
 
-    /* If we didn't print out any minus, do it now. */
-    if (neg) {
-        print_char(fd, '-');
-    }
+    print_pad(fd, min_width, precision, nuf_digits, neg ? "-" : NULL);
 
     /* Print out character by character by using the divider we just found. */
     /* This is the secret sauce to this no-buffering print routine. */
     while (1) {
         unsigned long digit = number / divider;
-        if (base == BASE_HEX_LOWER_CASE) {
-            print_char(fd, tohex_lc[digit]);
-        } else {
-            print_char(fd, tohex_uc[digit]);
-        }
+        print_char(fd, (char)('0' + digit));
         number = number - (unsigned int)(digit * divider);
-        divider /= base_num;
+        divider /= 10UL;
         if (divider == 0L) {
             break;
         }
@@ -312,7 +663,6 @@ print_ui(SPE_FILE *fd, unsigned int number, const enum base_t base,
  *
  * @param fd Pointer to filedescriptor to output result to.
  * @param number The actual number to print out.
- * @param base Base t print out number in, see enum base_t.
  * @param min_width Minimum field width.
  * @param precision Minimum number of digits to represent the integer.
  * @param neg Non-zero if a minus sign should be added. Determined by the
@@ -322,17 +672,18 @@ print_ui(SPE_FILE *fd, unsigned int number, const enum base_t base,
  * @retval -1 on failure.
  */
 static int
-print_si(SPE_FILE *fd, signed int number, const enum base_t base,
-         int min_width, int precision)
+print_si(SPE_FILE *fd, signed int number, int min_width, int precision)
 {
+    unsigned int magnitude = (unsigned int)number;
     int neg = 0;
 
+    /* Negate as unsigned, -INT_MIN does not fit in an int */
     if (number < 0) {
         neg = 1;
-        number = -number;
+        magnitude = 0U - magnitude;
     }
 
-    return print_ui(fd, (unsigned int)number, base, min_width, precision, neg);
+    return print_ui(fd, magnitude, min_width, precision, neg);
 } /* print_si */
 
 
@@ -347,7 +698,8 @@ print_si(SPE_FILE *fd, signed int number, const enum base_t base,
  * @param fd Pointer to filedescriptor to output result to.
  * @param fp The actual number to print out.
  * @param min_width Minimum field width.
- * @param precision Minimum number of digits to represent the integer.
+ * @param precision Number of decimals, -1 for the default.
+ * @param zero Non-zero to pad the integer part with zeros.
  *
  * @retval 0 on success.
  * @retval -1 on failure.
@@ -355,7 +707,7 @@ print_si(SPE_FILE *fd, signed int number, const enum base_t base,
 #ifdef USE_DOUBLE
 #define DOUBLE_DEFAULT_PRECISION 6
 static int
-print_d(SPE_FILE *fd, double fp, int min_width, int precision)
+print_d(SPE_FILE *fd, double fp, int min_width, int precision, int zero)
 {
     unsigned int ii, id;
     int n;
@@ -370,7 +722,7 @@ print_d(SPE_FILE *fd, double fp, int min_width, int precision)
     }
 
     /* If no precision given, revert to default */
-    if (precision == 0) {
+    if (precision < 0) {
         precision = DOUBLE_DEFAULT_PRECISION;
     }
 
@@ -385,7 +737,9 @@ print_d(SPE_FILE *fd, double fp, int min_width, int precision)
     id = (unsigned int)tmp;
 
     /* Punctuation is included in the min_width */
-    min_width -= 1;
+    if (precision) {
+        min_width -= 1;
+    }
 
     /* min_width is including all numbers, also decimal */
     min_width -= precision;
@@ -394,9 +748,11 @@ print_d(SPE_FILE *fd, double fp, int min_width, int precision)
     }
 
     /* Print it as the integer part, a dot and the decimal part */
-    print_ui(fd, ii, BASE_DECIMAL, min_width, 0, neg);
-    print_char(fd, '.');
-    print_ui(fd, id, BASE_DECIMAL, precision, precision, 0);
+    print_ui(fd, ii, min_width, zero ? min_width - neg : 0, neg);
+    if (precision) {
+        print_char(fd, '.');
+        print_ui(fd, id, precision, precision, 0);
+    }
 
     return 0;
 } /* printf_d */
@@ -404,185 +760,2135 @@ print_d(SPE_FILE *fd, double fp, int min_width, int precision)
 
 
 /**
- * \b print_string
+ * \b print_text
  *
  * This is an internal function not for use by application code.
  *
- * Print string to fd one character at a time.
+ * Print text up to its \0 or the first stop character. The kind of file
+ * descriptor is checked once for the whole text instead of once per
+ * character in print_char(). A string gets a copy loop with one bound, a
+ * callback a loop with the function pointer kept in a register.
  *
  * @param fd Pointer to filedescriptor to output result to.
- * @param string The actual string to print out.
+ * @param text The text to print out.
+ * @param stop Character ending the text, besides \0.
  *
- * @retval 0 on success.
- * @retval -1 on failure.
+ * @retval Number of characters of text printed.
  */
-static int
-print_string(SPE_FILE *fd, const char *string)
+static size_t
+print_text(SPE_FILE *fd, const char *text, const char stop)
 {
-    int i;
+    const char *c = text;
+
+    if (!fd->putc && fd->str) {
+        char *p = &fd->str[fd->curr];
+        char *const end = &fd->str[fd->max - 1];
+
+        while ((*c != 0) && (*c != stop) && (p < end)) {
+            *p++ = *c++;
+        }
+        fd->curr = (size_t)(p - fd->str);
+        if ((*c != 0) && (*c != stop)) {
+            fd->full = 1;
+        }
+    } else if (fd->putc && !fd->str) {
+        void (*const putc)(char) = fd->putc;
 
-    for (i = 0; string[i] != 0; i++) {
-        print_char(fd, string[i]);
+        while ((*c != 0) && (*c != stop)) {
+            putc(*c++);
+        }
+    } else {
+        while ((*c != 0) && (*c != stop)) {
+            print_char(fd, *c++);
+        }
     }
 
-    return 0;
-} /* print_string */
+    return (size_t)(c - text);
+} /* print_text */
 
 
 /**
- * \b conversion
+ * \b print_string
  *
  * This is an internal function not for use by application code.
  *
- * Conversion
- * Format string resolver.
+ * Print string to fd.
  *
  * @param fd Pointer to filedescriptor to output result to.
- * @param fmt The format string to use when formatting output.
- * @param i Index in fmt string we're trying to resolve.
- * @param ap Variable argument list to the print command
+ * @param string The actual string to print out.
  *
  * @retval 0 on success.
  * @retval -1 on failure.
  */
 static int
-conversion(SPE_FILE *fd, const char *fmt, int i, const va_list *ap)
+print_string(SPE_FILE *fd, const char *string)
 {
-    int long_modifier = 0;
-    int min_width = 0;
-    int precision = 0;
+    print_text(fd, string, 0);
 
-    /* Read in eventual minimum width given as first parameter after % */
-    while ((fmt[i + 1] >= '0') && (fmt[i + 1] <= '9')) {
-        min_width *= 10;
-        min_width += (fmt[i + 1] - '0');
-        i++;
-    }
+    return 0;
+} /* print_string */
 
-    while (1) {
-        i++;
-        switch (fmt[i]) {
-        case '%': /* Plain % */
-            print_char(fd, '%');
-            return i;
-            break;
-        case 'c': /* Character */
-            print_char(fd, (char)va_arg(*ap, int));
-            return i;
-        case 's': /* String */
-            print_string(fd, va_arg(*ap, char*));
-            return i;
-        case 'd': /* Signed integer and long */
-            if (long_modifier) {
-                print_sil(fd, va_arg(*ap, long), BASE_DECIMAL, min_width,
-                          precision);
-            } else {
-                print_si(fd, va_arg(*ap, int), BASE_DECIMAL, min_width,
-                         precision);
-            }
-            return i;
-        case 'l': /* long modifier, used with u and d */
-            long_modifier = 1;
-            break;
-        case 'u': /* Unsigned integer and long */
-            if (long_modifier) {
-                print_uil(fd, va_arg(*ap, unsigned long), BASE_DECIMAL,
-                          min_width, precision, 0);
-            } else {
-                print_ui(fd, va_arg(*ap, unsigned int), BASE_DECIMAL,
-                         min_width, precision, 0);
-            }
-            return i;
-        case 'x': /* Hex */
-            if (long_modifier) {
-                print_uil(fd, va_arg(*ap, unsigned long), BASE_HEX_LOWER_CASE,
-                          min_width, precision, 0);
-            } else {
-                print_ui(fd, va_arg(*ap, unsigned int), BASE_HEX_LOWER_CASE,
-                         min_width, precision, 0);
-            }
-            return i;
-        case 'X': /* Hex */
-            if (long_modifier) {
-                print_uil(fd, va_arg(*ap, unsigned long), BASE_HEX_UPPER_CASE,
-                          min_width, precision, 0);
-            } else {
-                print_ui(fd, va_arg(*ap, unsigned int), BASE_HEX_UPPER_CASE,
-                         min_width, precision, 0);
-            }
-            return i;
-#ifdef USE_DOUBLE
-        case 'f':
-            print_d(fd, va_arg(*ap, double), min_width, precision);
-            return i;
-#else
-            return -1;
-#endif /* USE_DOUBLE */
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-            precision *= 10;
-            precision += (fmt[i] - '0');
-            break;
-        case '.':
-            break;
-        default:
-            return -1;
-        }
-    }
 
-    return 0;
-} /* conversion */
+#ifdef USE_BIGINT
+/*
+ * Limbs of a big integer, half an unsigned long each, so that a limb with
+ * the remainder above it fits in an unsigned long. Dividing that by the
+ * constant CHUNK is then a multiplication by its reciprocal, not a library
+ * call, also on Cortex-M3.
+ */
+#if ULONG_MAX > 0xffffffffUL
+typedef uint32_t big_limb;
+#define LIMB_BITS     32
+#define CHUNK         1000000000UL /* Largest power of ten below 2^32 */
+#define CHUNK_DIGITS  9
+#else
+typedef uint16_t big_limb;
+#define LIMB_BITS     16
+#define CHUNK         10000UL      /* Largest power of ten below 2^16 */
+#define CHUNK_DIGITS  4
+#endif
+#define LIMBS_PER_WORD (32 / LIMB_BITS)
 
+/* Decimal digits of a number of SPE_BIGINT_MAX_WORDS words */
+#define BIG_DIGITS ((SPE_BIGINT_MAX_WORDS * 32 * 1233 + 4095) / 4096)
 
-/**@name General versions */
-/**@{*/
 /**
- * \b spe_fprintf
+ * \b big_decimal
  *
- * Refer to fprintf() in libc.
+ * This is an internal function not for use by application code.
  *
- * @param fd A pointer to the file descriptor.
- * @param fmt Format string for formatting the text.
- * @param ... A list of parameters to be displayed.
+ * Write the decimal digits of a big integer backwards from end. Each pass
+ * divides all limbs by CHUNK, most significant first, and the remainder is
+ * the next CHUNK_DIGITS digits. Limbs that became zero are left out of the
+ * following passes, so a 128 bit number takes five passes of at most four
+ * limbs where unsigned long is 64 bits.
  *
- * @retval 0 On success.
- * @retval -1 On failure.
+ * Only included if USE_BIGINT is defined.
+ *
+ * @param limbs The number, least significant limb first. Is zero after.
+ * @param nuf_limbs Number of limbs.
+ * @param end Behind where the last digit goes.
+ *
+ * @retval Pointer to the first digit.
  */
-int
-spe_fprintf(SPE_FILE *fd, const char *fmt, ...)
+static char *
+big_decimal(big_limb *limbs, int nuf_limbs, char *end)
 {
-    va_list ap;
-    int returned;
+    for (; (nuf_limbs > 0) && !limbs[nuf_limbs - 1]; nuf_limbs--) {
+    }
+    do {
+        unsigned long rem = 0;
+        int k;
 
-    va_start(ap, fmt);
-    returned = spe_vfprintf(fd, fmt, ap);
-    va_end(ap);
+        for (k = nuf_limbs - 1; k >= 0; k--) {
+            const unsigned long cur = (rem << LIMB_BITS) | limbs[k];
 
-    return returned;
-} /* spe_fprintf */
+            limbs[k] = (big_limb)(cur / CHUNK);
+            rem = cur % CHUNK;
+        }
+        for (; (nuf_limbs > 0) && !limbs[nuf_limbs - 1]; nuf_limbs--) {
+        }
+        if (nuf_limbs > 0) {
+            /* Not the most significant chunk, keep its zeros */
+            for (k = 0; k < CHUNK_DIGITS; k++) {
+                *--end = (char)('0' + rem % 10UL);
+                rem /= 10UL;
+            }
+        } else {
+            do {
+                *--end = (char)('0' + rem % 10UL);
+                rem /= 10UL;
+            } while (rem);
+        }
+    } while (nuf_limbs > 0);
+
+    return end;
+} /* big_decimal */
 
 
 /**
- * \b spe_printf
+ * \b negate_limbs
  *
- * Refer to printf() in libc.
- * Note that spe_stdout must have been defined.
+ * This is an internal function not for use by application code.
  *
- * @param fmt Format string for formatting the text.
- * @param ... A list of parameters to be displayed.
+ * Two's complement of a big integer, in place.
  *
- * @retval 0 On success.
- * @retval -1 On failure.
+ * Only included if USE_BIGINT is defined.
+ *
+ * @param limbs The number, least significant limb first.
+ * @param nuf_limbs Number of limbs.
  */
-int
+static void
+negate_limbs(big_limb *limbs, const int nuf_limbs)
+{
+    unsigned long carry = 1UL;
+    int k;
+
+    for (k = 0; k < nuf_limbs; k++) {
+        carry += (big_limb)~limbs[k];
+        limbs[k] = (big_limb)carry;
+        carry >>= LIMB_BITS;
+    }
+} /* negate_limbs */
+
+
+/**
+ * \b print_big
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print a big integer in decimal, with minimal width and precision as for
+ * the other integers.
+ *
+ * Only included if USE_BIGINT is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param limbs The number, least significant limb first. Is changed.
+ * @param nuf_limbs Number of limbs.
+ * @param is_signed Non-zero if the top bit is a sign bit.
+ * @param spec Width, precision and flags.
+ * @param end The \0 ending a buffer with room for the digits in front.
+ */
+static void
+print_big(SPE_FILE *fd, big_limb *limbs, const int nuf_limbs,
+          const int is_signed, const struct spe_conv_spec *spec, char *end)
+{
+    const int neg = is_signed &&
+        ((limbs[nuf_limbs - 1] >> (LIMB_BITS - 1)) & 1U);
+    const char *first;
+    int precision;
+
+    if (neg) {
+        negate_limbs(limbs, nuf_limbs);
+    }
+    first = big_decimal(limbs, nuf_limbs, end);
+    precision = spec->precision;
+    if ((precision < 0) && (spec->flags & SPE_FLAG_ZERO)) {
+        precision = spec->min_width - neg;
+    }
+    print_pad(fd, spec->min_width, precision, (int)(end - first),
+              neg ? "-" : NULL);
+    print_text(fd, first, 0);
+} /* print_big */
+
+
+/**
+ * \b print_u128
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print a struct spe_u128 in decimal.
+ *
+ * Only included if USE_BIGINT is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param value The number.
+ * @param is_signed Non-zero for %pWd.
+ * @param spec Width, precision and flags.
+ */
+static void
+print_u128(SPE_FILE *fd, const struct spe_u128 *value, const int is_signed,
+           const struct spe_conv_spec *spec)
+{
+    big_limb limbs[128 / LIMB_BITS];
+    char digits[39 + 1];
+    const int half = 64 / LIMB_BITS;
+    int k;
+
+    for (k = 0; k < half; k++) {
+        limbs[k] = (big_limb)(value->lo >> (k * LIMB_BITS));
+        limbs[half + k] = (big_limb)(value->hi >> (k * LIMB_BITS));
+    }
+    digits[39] = '\0';
+    print_big(fd, limbs, 128 / LIMB_BITS, is_signed, spec, &digits[39]);
+} /* print_u128 */
+#endif /* USE_BIGINT */
+
+
+/**
+ * \b print_run
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print len characters of text, copied in one go to a string. As in
+ * print_text(), the kind of file descriptor is checked once. A \0 in the
+ * text is printed like any other character.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param text The characters to print out.
+ * @param len Number of characters.
+ */
+static void
+print_run(SPE_FILE *fd, const char *text, size_t len)
+{
+    size_t i;
+
+    if (!fd->putc && fd->str) {
+        const size_t room = (fd->max - 1) - fd->curr;
+
+        if (len > room) {
+            len = room;
+            fd->full = 1;
+        }
+        memcpy(&fd->str[fd->curr], text, len);
+        fd->curr += len;
+    } else if (fd->putc && !fd->str) {
+        void (*const putc)(char) = fd->putc;
+
+        for (i = 0; i < len; i++) {
+            putc(text[i]);
+        }
+    } else {
+        for (i = 0; i < len; i++) {
+            print_char(fd, text[i]);
+        }
+    }
+} /* print_run */
+
+
+#ifdef USE_UTF8
+/**
+ * \b utf8_prefix
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Find how many bytes the first code points of text take. Runs of ASCII
+ * are skipped eight bytes at a time. A sequence is one code point only if
+ * its lead byte is valid and all its continuation bytes follow, anything
+ * else counts one byte as one code point, so a broken string is still
+ * cut somewhere and never in the middle of a valid character.
+ *
+ * Only included if USE_UTF8 is defined.
+ *
+ * @param text The characters.
+ * @param len Number of characters, none of them \0.
+ * @param points In: the most code points wanted. Out: the number found.
+ *
+ * @retval Number of bytes of the code points found.
+ */
+static size_t
+utf8_prefix(const char *text, const size_t len, int *points)
+{
+    const unsigned char *const u = (const unsigned char *)text;
+    const int max = *points;
+    int found = 0;
+    size_t i = 0;
+
+    while ((found < max) && (i < len)) {
+        size_t k, seq;
+
+#ifdef SPE_SWAR
+        if ((i + 8U <= len) && (max - found >= 8)) {
+            uint64_t x;
+
+            memcpy(&x, &u[i], sizeof(x));
+            x &= HIGHS;
+            if (!x) {
+                i += 8U;
+                found += 8;
+                continue;
+            }
+#ifdef __GNUC__
+            k = (size_t)__builtin_ctzll(x) / 8U;
+            i += k;
+            found += (int)k;
+#endif
+        }
+#endif /* SPE_SWAR */
+        if (u[i] < 0x80U) {
+            seq = 1;
+        } else if (u[i] < 0xc2U) {
+            seq = 1; /* Continuation or overlong lead byte */
+        } else if (u[i] < 0xe0U) {
+            seq = 2;
+        } else if (u[i] < 0xf0U) {
+            seq = 3;
+        } else if (u[i] < 0xf5U) {
+            seq = 4;
+        } else {
+            seq = 1;
+        }
+        for (k = 1; k < seq; k++) {
+            if ((i + k >= len) || ((u[i + k] & 0xc0U) != 0x80U)) {
+                seq = 1;
+                break;
+            }
+        }
+        i += seq;
+        found++;
+    }
+    *points = found;
+
+    return i;
+} /* utf8_prefix */
+
+
+/**
+ * \b print_utf8
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print at most precision code points of a UTF-8 string, %.Ns. No more
+ * of the string than four bytes per code point is read, so it need not
+ * be terminated if it is long enough.
+ *
+ * Only included if USE_UTF8 is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param string The string to print out.
+ * @param precision Maximal number of code points.
+ */
+static void
+print_utf8(SPE_FILE *fd, const char *string, const int precision)
+{
+    const size_t most = ((size_t)precision > SIZE_MAX / 4U) ?
+        SIZE_MAX : (size_t)precision * 4U;
+    const char *const end = memchr(string, '\0', most);
+    int points = precision;
+
+    print_run(fd, string,
+              utf8_prefix(string, end ? (size_t)(end - string) : most,
+                          &points));
+} /* print_utf8 */
+
+
+/**
+ * \b utf8_encode
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Encode a code point as UTF-8. Surrogates and values above U+10FFFF are
+ * not characters and become U+FFFD, the replacement character.
+ *
+ * Only included if USE_UTF8 is defined.
+ *
+ * @param cp The code point.
+ * @param out Room for four bytes.
+ *
+ * @retval Number of bytes written, 1 to 4.
+ */
+static size_t
+utf8_encode(unsigned long cp, char *out)
+{
+    if (cp < 0x80UL) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800UL) {
+        out[0] = (char)(0xc0UL | (cp >> 6));
+        out[1] = (char)(0x80UL | (cp & 0x3fUL));
+        return 2;
+    }
+    if (((cp >= 0xd800UL) && (cp < 0xe000UL)) || (cp > 0x10ffffUL)) {
+        cp = 0xfffdUL;
+    }
+    if (cp < 0x10000UL) {
+        out[0] = (char)(0xe0UL | (cp >> 12));
+        out[1] = (char)(0x80UL | ((cp >> 6) & 0x3fUL));
+        out[2] = (char)(0x80UL | (cp & 0x3fUL));
+        return 3;
+    }
+    out[0] = (char)(0xf0UL | (cp >> 18));
+    out[1] = (char)(0x80UL | ((cp >> 12) & 0x3fUL));
+    out[2] = (char)(0x80UL | ((cp >> 6) & 0x3fUL));
+    out[3] = (char)(0x80UL | (cp & 0x3fUL));
+    return 4;
+} /* utf8_encode */
+
+
+#define WIDE_CHUNK 32 /* Bytes of UTF-8 encoded before printing them */
+
+/**
+ * \b print_wide
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print a wide string as UTF-8, %ls. The characters are encoded into a
+ * small chunk on the stack, which is printed whenever it is full. With a
+ * 16 bit wchar_t the string is taken as UTF-16 and surrogate pairs are
+ * joined. As in C99 the precision is a number of bytes, and a character
+ * that would not fit in it is left out whole.
+ *
+ * Only included if USE_UTF8 is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param string The wide string to print out.
+ * @param precision Maximal number of bytes, or -1 for all.
+ */
+static void
+print_wide(SPE_FILE *fd, const wchar_t *string, const int precision)
+{
+    char chunk[WIDE_CHUNK];
+    size_t used = 0;
+    size_t room = (precision < 0) ? SIZE_MAX : (size_t)precision;
+
+    if (!string) {
+        print_text(fd, "(null)", 0);
+        return;
+    }
+
+    for (; string[0]; string++) {
+        unsigned long cp = (unsigned long)string[0];
+        size_t len;
+
+#if WCHAR_MAX <= 0xffff
+        if ((cp >= 0xd800UL) && (cp < 0xdc00UL) &&
+            ((unsigned long)string[1] >= 0xdc00UL) &&
+            ((unsigned long)string[1] < 0xe000UL)) {
+            cp = 0x10000UL + ((cp - 0xd800UL) << 10) +
+                ((unsigned long)string[1] - 0xdc00UL);
+            string++;
+        }
+#endif
+        if (used > sizeof(chunk) - 4U) {
+            if (fd->full) {
+                return;
+            }
+            print_run(fd, chunk, used);
+            used = 0;
+        }
+        len = utf8_encode(cp, &chunk[used]);
+        if (len > room) {
+            break;
+        }
+        room -= len;
+        used += len;
+    }
+    print_run(fd, chunk, used);
+} /* print_wide */
+#endif /* USE_UTF8 */
+
+
+#ifdef USE_QUOTED
+#ifdef SPE_SWAR
+/**
+ * \b bytes_below
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Top bit set in the bytes of x below n, at most 0x80. Bytes above the
+ * lowest one found may be set too, from the borrow, but never below it.
+ *
+ * Only included if USE_QUOTED is defined.
+ *
+ * @param x Eight characters.
+ * @param n Limit.
+ *
+ * @retval Top bits of the bytes found.
+ */
+static uint64_t
+bytes_below(const uint64_t x, const unsigned int n)
+{
+    return (x - ONES * n) & ~x & HIGHS;
+} /* bytes_below */
+#endif /* SPE_SWAR */
+
+
+/**
+ * \b needs_escape
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Only included if USE_QUOTED is defined.
+ *
+ * @param c Character of the string.
+ * @param json Non-zero for JSON, zero for C.
+ *
+ * @retval 1 if c can't be printed as it is.
+ * @retval 0 otherwise.
+ */
+static int
+needs_escape(const char c, const int json)
+{
+    return ((unsigned char)c < 0x20U) || (c == '"') || (c == '\\') ||
+        (!json && (c == 0x7f));
+} /* needs_escape */
+
+
+/**
+ * \b clean_run
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Number of characters from the start of text that can be printed as they
+ * are. Where 64 bit little endian loads are available, eight characters
+ * are checked at once: control characters, quote, backslash and for C
+ * also DEL each set the top bit of their byte, and the lowest one found is
+ * the end of the run.
+ *
+ * Only included if USE_QUOTED is defined.
+ *
+ * @param text The characters.
+ * @param len Number of characters, none of them \0.
+ * @param json Non-zero for JSON, zero for C.
+ *
+ * @retval Length of the run.
+ */
+static size_t
+clean_run(const char *text, const size_t len, const int json)
+{
+    size_t i = 0;
+
+#ifdef SPE_SWAR
+    for (; i + 8U <= len; i += 8U) {
+        uint64_t x, found;
+
+        memcpy(&x, &text[i], sizeof(x));
+        found = bytes_below(x, 0x20U) |
+            bytes_below(x ^ (ONES * '"'), 1U) |
+            bytes_below(x ^ (ONES * '\\'), 1U);
+        if (!json) {
+            found |= bytes_below(x ^ (ONES * 0x7fU), 1U);
+        }
+        if (found) {
+#ifdef __GNUC__
+            return i + (size_t)__builtin_ctzll(found) / 8U;
+#else
+            break;
+#endif
+        }
+    }
+#endif /* SPE_SWAR */
+    for (; (i < len) && !needs_escape(text[i], json); i++) {
+    }
+    return i;
+} /* clean_run */
+
+
+/**
+ * \b print_escape
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print the escape sequence of a character. Other control characters are
+ * \u00XX in JSON and three octal digits in C, which unlike \x can't run
+ * into a following digit.
+ *
+ * Only included if USE_QUOTED is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param c Character needing an escape.
+ * @param json Non-zero for JSON, zero for C.
+ */
+static void
+print_escape(SPE_FILE *fd, const char c, const int json)
+{
+    const unsigned char u = (unsigned char)c;
+    char short_form = 0;
+
+    switch (c) {
+    case '"':
+    case '\\':
+        short_form = c;
+        break;
+    case '\n':
+        short_form = 'n';
+        break;
+    case '\r':
+        short_form = 'r';
+        break;
+    case '\t':
+        short_form = 't';
+        break;
+    case '\b':
+        short_form = 'b';
+        break;
+    case '\f':
+        short_form = 'f';
+        break;
+    default:
+        break;
+    }
+
+    print_char(fd, '\\');
+    if (short_form) {
+        print_char(fd, short_form);
+    } else if (json) {
+        print_text(fd, "u00", 0);
+        print_char(fd, tohex_lc[u >> 4]);
+        print_char(fd, tohex_lc[u & 0x0fU]);
+    } else {
+        print_char(fd, (char)('0' + (u >> 6)));
+        print_char(fd, (char)('0' + ((u >> 3) & 7U)));
+        print_char(fd, (char)('0' + (u & 7U)));
+    }
+} /* print_escape */
+
+
+/**
+ * \b print_quoted
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print string within double quotes, escaped as a C string literal or a
+ * JSON string. Runs of characters needing no escape are copied in one go.
+ * Characters from 0x80 are printed as they are, so UTF-8 passes through.
+ * A NULL string is (null), or null in JSON.
+ *
+ * Only included if USE_QUOTED is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param string The string to print out, or NULL.
+ * @param json Non-zero for JSON, zero for C.
+ */
+static void
+print_quoted(SPE_FILE *fd, const char *string, const int json)
+{
+    size_t len, i = 0;
+
+    if (!string) {
+        print_text(fd, json ? "null" : "(null)", 0);
+        return;
+    }
+
+    len = strlen(string);
+    print_char(fd, '"');
+    while ((i < len) && !fd->full) {
+        const size_t run = clean_run(&string[i], len - i, json);
+
+        print_run(fd, &string[i], run);
+        i += run;
+        if (i < len) {
+            print_escape(fd, string[i++], json);
+        }
+    }
+    print_char(fd, '"');
+} /* print_quoted */
+#endif /* USE_QUOTED */
+
+
+#ifdef USE_BLOB
+/* Size of the chunks encoded on the stack, a multiple of both 4 and 5 */
+#define BLOB_CHUNK 60
+
+static const char base64_digits[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char z85_digits[] =
+    "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    ".-:+=^!/*?&<>()[]{}@%$#";
+
+/**
+ * \b print_base64
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print len bytes as base64 with padding, RFC 4648. Each group of three
+ * bytes is four table lookups into a chunk on the stack, and the chunk is
+ * printed in one go when full.
+ *
+ * Only included if USE_BLOB is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param data The bytes to encode.
+ * @param len Number of bytes.
+ */
+static void
+print_base64(SPE_FILE *fd, const unsigned char *data, size_t len)
+{
+    char chunk[BLOB_CHUNK];
+    size_t used = 0;
+
+    for (; (len >= 3U) && !fd->full; data += 3, len -= 3U) {
+        const unsigned long group = ((unsigned long)data[0] << 16) |
+            ((unsigned long)data[1] << 8) | data[2];
+
+        chunk[used] = base64_digits[group >> 18];
+        chunk[used + 1U] = base64_digits[(group >> 12) & 0x3fU];
+        chunk[used + 2U] = base64_digits[(group >> 6) & 0x3fU];
+        chunk[used + 3U] = base64_digits[group & 0x3fU];
+        used += 4U;
+        if (used == sizeof(chunk)) {
+            print_run(fd, chunk, used);
+            used = 0;
+        }
+    }
+    if ((len > 0U) && !fd->full) {
+        const unsigned long group = ((unsigned long)data[0] << 16) |
+            ((len > 1U) ? ((unsigned long)data[1] << 8) : 0U);
+
+        chunk[used] = base64_digits[group >> 18];
+        chunk[used + 1U] = base64_digits[(group >> 12) & 0x3fU];
+        chunk[used + 2U] = (len > 1U) ? base64_digits[(group >> 6) & 0x3fU] :
+            '=';
+        chunk[used + 3U] = '=';
+        used += 4U;
+    }
+    print_run(fd, chunk, used);
+} /* print_base64 */
+
+
+/**
+ * \b print_base85
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print len bytes as base85 with the Z85 alphabet, which has no quotes or
+ * backslash and so goes into C and JSON strings as it is. Each group of
+ * four bytes, big endian, is five digits. A last group of one to three
+ * bytes is padded with zeros and only its first one to three plus one
+ * digits are printed, as in Ascii85, so any length can be encoded.
+ *
+ * Only included if USE_BLOB is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param data The bytes to encode.
+ * @param len Number of bytes.
+ */
+static void
+print_base85(SPE_FILE *fd, const unsigned char *data, size_t len)
+{
+    char chunk[BLOB_CHUNK];
+    size_t used = 0;
+
+    while ((len > 0U) && !fd->full) {
+        const size_t take = (len < 4U) ? len : 4U;
+        unsigned long group = 0;
+        size_t k;
+
+        for (k = 0; k < 4U; k++) {
+            group = (group << 8) | ((k < take) ? data[k] : 0U);
+        }
+        for (k = 5U; k-- > 0U;) {
+            chunk[used + k] = z85_digits[group % 85U];
+            group /= 85U;
+        }
+        used += (take < 4U) ? take + 1U : 5U;
+        data += take;
+        len -= take;
+        if (used == sizeof(chunk)) {
+            print_run(fd, chunk, used);
+            used = 0;
+        }
+    }
+    print_run(fd, chunk, used);
+} /* print_base85 */
+
+
+/**
+ * \b print_blob
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print len bytes of binary data as base64 or base85. The length is the
+ * width of the conversion, `%*pB`, as for %*ph of Linux, since gcc's format
+ * check accepts a width with %p but not a precision. It must be given. A
+ * NULL pointer is (nil), as for %p.
+ *
+ * Only included if USE_BLOB is defined.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param data The bytes to encode, or NULL.
+ * @param spec Width, the number of bytes, and the rest of the conversion.
+ * @param base85 Non-zero for base85, zero for base64.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure.
+ */
+static int
+print_blob(SPE_FILE *fd, const void *data, const struct spe_conv_spec *spec,
+           const int base85)
+{
+    const int len = spec->min_width;
+
+    if ((len < 0) ||
+        ((len == 0) && !(spec->flags & SPE_FLAG_WIDTH_STAR))) {
+        return -1;
+    }
+    if (!data) {
+        print_text(fd, "(nil)", 0);
+    } else if (base85) {
+        print_base85(fd, data, (size_t)len);
+    } else {
+        print_base64(fd, data, (size_t)len);
+    }
+    return 0;
+} /* print_blob */
+#endif /* USE_BLOB */
+
+
+#ifdef USE_TIMESTAMP
+/**
+ * \b print_2d
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_TIMESTAMP is defined.
+ *
+ * Print a number between 0 and 99 as exactly two digits.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param number The actual number to print out.
+ */
+static void
+print_2d(SPE_FILE *fd, unsigned int number)
+{
+    print_char(fd, (char)('0' + number / 10U));
+    print_char(fd, (char)('0' + number % 10U));
+} /* print_2d */
+
+
+/**
+ * \b time_prefix
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_TIMESTAMP is defined.
+ *
+ * Render "YYYY-MM-DDThh:" for the given hour since epoch into the cache.
+ * Civil date from days uses the era based algorithm by Howard Hinnant, see
+ * http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+ *
+ * @param cache The cache to fill in.
+ * @param hour Number of hours since 1970-01-01T00:00.
+ */
+static void
+time_prefix(struct spe_time_cache *cache, unsigned long hour)
+{
+    unsigned long z = hour / 24UL + 719468UL;
+    unsigned long era = z / 146097UL;
+    unsigned long doe = z - era * 146097UL;
+    unsigned long yoe = (doe - doe / 1460UL + doe / 36524UL
+                         - doe / 146096UL) / 365UL;
+    unsigned long doy = doe - (365UL * yoe + yoe / 4UL - yoe / 100UL);
+    unsigned long mp = (5UL * doy + 2UL) / 153UL;
+    unsigned long day = doy - (153UL * mp + 2UL) / 5UL + 1UL;
+    unsigned long month = (mp < 10UL) ? mp + 3UL : mp - 9UL;
+    unsigned long year = yoe + era * 400UL + ((month <= 2UL) ? 1UL : 0UL);
+    SPE_FILE pfd = {
+        .putc = NULL,
+        .str = cache->prefix,
+        .max = sizeof(cache->prefix) + 1,
+        .curr = 0,
+        .full = 0,
+    };
+
+    print_uil(&pfd, year, 4, 4, 0);
+    print_char(&pfd, '-');
+    print_2d(&pfd, (unsigned int)month);
+    print_char(&pfd, '-');
+    print_2d(&pfd, (unsigned int)day);
+    print_char(&pfd, 'T');
+    print_2d(&pfd, (unsigned int)(hour % 24UL));
+    print_char(&pfd, ':');
+
+    cache->hour = hour + 1UL;
+} /* time_prefix */
+
+
+#define LAST_TIMESTAMP 253402300799ULL /* 9999-12-31T23:59:59Z in seconds */
+
+/**
+ * \b print_time
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_TIMESTAMP is defined.
+ *
+ * Print a timestamp as ISO-8601 UTC (2021-03-04T05:06:07.890Z) or a
+ * duration as hours, minutes and seconds (123:04:05.678). The date and hour
+ * of the last timestamp is cached in the file descriptor, so only minutes,
+ * seconds and fraction are converted as long as the hour stays the same.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param t Seconds, milliseconds or microseconds since epoch/start.
+ * @param unit 's', 'm' or 'u' for the unit of t.
+ * @param duration Non-zero to print a duration instead of a timestamp.
+ *
+ * @retval 0 on success.
+ * @retval -1 on failure, or for a timestamp after the year 9999.
+ */
+static int
+print_time(SPE_FILE *fd, unsigned long long t, const char unit, int duration)
+{
+    unsigned long scale;
+    int digits;
+    unsigned long long secs;
+    unsigned long hour;
+    unsigned int sec_of_hour, frac;
+
+    switch (unit) {
+    case 's':
+        scale = 1UL;
+        digits = 0;
+        break;
+    case 'm':
+        scale = 1000UL;
+        digits = 3;
+        break;
+    case 'u':
+        scale = 1000000UL;
+        digits = 6;
+        break;
+    default:
+        return -1;
+    }
+
+    secs = t / scale;
+    if (!duration && (secs > LAST_TIMESTAMP)) {
+        return -1; /* The year takes more than four digits */
+    }
+    frac = (unsigned int)(t - secs * scale);
+    hour = (unsigned long)(secs / 3600U);
+    sec_of_hour = (unsigned int)(secs - (unsigned long long)hour * 3600U);
+
+    if (duration) {
+        print_uil(fd, hour, 2, 2, 0);
+        print_char(fd, ':');
+    } else {
+        int i;
+
+        if (fd->tcache.hour != hour + 1UL) {
+            time_prefix(&fd->tcache, hour);
+        }
+        for (i = 0; i < (int)sizeof(fd->tcache.prefix); i++) {
+            print_char(fd, fd->tcache.prefix[i]);
+        }
+    }
+    print_2d(fd, sec_of_hour / 60U);
+    print_char(fd, ':');
+    print_2d(fd, sec_of_hour % 60U);
+    if (digits) {
+        print_char(fd, '.');
+        print_ui(fd, frac, digits, digits, 0);
+    }
+    if (!duration) {
+        print_char(fd, 'Z');
+    }
+
+    return 0;
+} /* print_time */
+#endif /* USE_TIMESTAMP */
+
+
+#ifdef USE_CUSTOM_CONVERSION
+/**
+ * Registered custom conversions, indexed by the character following %p.
+ */
+static spe_conv_fn custom_conversions[128];
+#endif /* USE_CUSTOM_CONVERSION */
+
+/**
+ * Where the arguments of the conversions come from, the va_list of the
+ * call or, with USE_ARG_PACK, an array of typed arguments.
+ */
+struct arg_source {
+    va_list *ap;                /* NULL when reading a pack */
+#ifdef USE_ARG_PACK
+    const struct spe_arg *next; /* Next argument of the pack */
+    const struct spe_arg *end;  /* Behind the last argument of the pack */
+#endif
+    union spe_arg_value value;  /* Last argument fetched */
+};
+
+#ifdef USE_ARG_PACK
+/**
+ * Argument types that may stand in for each other in a pack, as they can
+ * in a va_list.
+ */
+static const unsigned char arg_class[NUF_SPE_ARG_TYPES] = {
+    [SPE_ARG_TYPE_INT] = 0, [SPE_ARG_TYPE_UINT] = 0,
+    [SPE_ARG_TYPE_LONG] = 1, [SPE_ARG_TYPE_ULONG] = 1,
+    [SPE_ARG_TYPE_U64] = 2,
+    [SPE_ARG_TYPE_DOUBLE] = 3,
+    [SPE_ARG_TYPE_STRING] = 4, [SPE_ARG_TYPE_POINTER] = 4,
+};
+#endif /* USE_ARG_PACK */
+
+
+#ifdef USE_ARG_PACK
+/**
+ * \b pack_arg
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Fetch the next argument of a pack into src->value. The argument must be
+ * of type or one that may stand in for it, and a timestamp may also be
+ * given by pointer, as in a va_list.
+ *
+ * @param src Where the arguments come from.
+ * @param type Type the conversion needs.
+ *
+ * @retval 0 on success.
+ * @retval -1 if there are no more arguments or one of the wrong type.
+ */
+static int
+pack_arg(struct arg_source *src, const enum spe_arg_type type)
+{
+    const struct spe_arg *arg = src->next;
+
+    if (arg == src->end) {
+        return -1;
+    }
+    src->next++;
+    if ((unsigned int)arg->type >= NUF_SPE_ARG_TYPES) {
+        return -1;
+    }
+    if ((type == SPE_ARG_TYPE_U64) && (arg->type == SPE_ARG_TYPE_POINTER)) {
+        src->value.u64 = *(const unsigned long long *)arg->v.p;
+        return 0;
+    }
+    if (arg_class[arg->type] != arg_class[type]) {
+        return -1;
+    }
+    src->value = arg->v;
+    return 0;
+} /* pack_arg */
+#endif /* USE_ARG_PACK */
+
+
+/**
+ * \b next_arg
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Fetch the next argument into src->value, read as type from a va_list.
+ * Small enough to be inlined, where type is a constant and the switch
+ * disappears.
+ *
+ * @param src Where the arguments come from.
+ * @param type Type the conversion needs.
+ *
+ * @retval 0 on success.
+ * @retval -1 if a pack has no more arguments or one of the wrong type.
+ */
+static int
+next_arg(struct arg_source *src, const enum spe_arg_type type)
+{
+#ifdef USE_ARG_PACK
+    if (!src->ap) {
+        return pack_arg(src, type);
+    }
+#endif
+
+    switch (type) {
+    case SPE_ARG_TYPE_INT:
+        src->value.i = va_arg(*src->ap, int);
+        break;
+    case SPE_ARG_TYPE_UINT:
+        src->value.u = va_arg(*src->ap, unsigned int);
+        break;
+    case SPE_ARG_TYPE_LONG:
+        src->value.l = va_arg(*src->ap, long);
+        break;
+    case SPE_ARG_TYPE_ULONG:
+        src->value.ul = va_arg(*src->ap, unsigned long);
+        break;
+    case SPE_ARG_TYPE_U64: /* %pT and %pD take a pointer */
+        src->value.u64 = *va_arg(*src->ap, const unsigned long long *);
+        break;
+    case SPE_ARG_TYPE_DOUBLE:
+#ifdef USE_DOUBLE
+        src->value.d = va_arg(*src->ap, double);
+#endif
+        break;
+    case SPE_ARG_TYPE_STRING:
+        src->value.s = va_arg(*src->ap, const char *);
+        break;
+    case SPE_ARG_TYPE_POINTER:
+        src->value.p = va_arg(*src->ap, const void *);
+        break;
+    case NUF_SPE_ARG_TYPES:
+    default:
+        return -1;
+    }
+    return 0;
+} /* next_arg */
+
+
+#ifdef POINTER_EXTENSIONS
+/**
+ * Characters following %p that are handled by the library itself.
+ */
+static const char builtin_extensions[] =
+#ifdef USE_TIMESTAMP
+    "TD"
+#endif
+#ifdef USE_QUOTED
+    "QJ"
+#endif
+#ifdef USE_BLOB
+    "BA"
+#endif
+#ifdef USE_BIGINT
+    "W"
+#endif
+    "";
+
+/**
+ * \b is_builtin_extension
+ *
+ * This is an internal function not for use by application code.
+ *
+ * @param ext The character following %p.
+ *
+ * @retval 1 if ext is handled by the library itself.
+ * @retval 0 otherwise.
+ */
+static int
+is_builtin_extension(const char ext)
+{
+    int i;
+
+    for (i = 0; builtin_extensions[i] != 0; i++) {
+        if (builtin_extensions[i] == ext) {
+            return 1;
+        }
+    }
+    return 0;
+} /* is_builtin_extension */
+
+
+/**
+ * \b is_pointer_extension
+ *
+ * This is an internal function not for use by application code.
+ *
+ * A %p followed by anything else than a built in or registered extension
+ * is a plain pointer, with the following characters as ordinary text.
+ *
+ * @param ext The character following %p.
+ *
+ * @retval 1 if ext is a built in or registered extension.
+ * @retval 0 otherwise.
+ */
+static int
+is_pointer_extension(const char ext)
+{
+    if (is_builtin_extension(ext)) {
+        return 1;
+    }
+#ifdef USE_CUSTOM_CONVERSION
+    return ((unsigned char)ext < 128U) && custom_conversions[(int)ext];
+#else
+    return 0;
+#endif
+} /* is_pointer_extension */
+
+
+/**
+ * \b pointer_extension
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Resolve the character(s) following %p. Built in extensions are handled
+ * first, anything else is looked up in the table of custom conversions.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param ext The character following %p.
+ * @param spec Width, precision and modifiers parsed before %p.
+ * @param src Where the arguments come from.
+ * @param i Index in fmt string of ext.
+ *
+ * @retval >=0 Index in fmt string of the last character consumed.
+ * @retval -1 on failure.
+ */
+static int
+pointer_extension(SPE_FILE *fd, const char ext,
+                  const struct spe_conv_spec *spec, struct arg_source *src,
+                  int i)
+{
+    switch (ext) {
+#ifdef USE_TIMESTAMP
+    case 'T': /* Timestamp */
+    case 'D': /* Duration */
+        if ((next_arg(src, SPE_ARG_TYPE_U64) < 0) ||
+            (print_time(fd, src->value.u64, spec->suffix[0],
+                        ext == 'D') < 0)) {
+            return -1;
+        }
+        return i + 1;
+#endif /* USE_TIMESTAMP */
+#ifdef USE_QUOTED
+    case 'Q': /* C string literal */
+    case 'J': /* JSON string */
+        if (next_arg(src, SPE_ARG_TYPE_STRING) < 0) {
+            return -1;
+        }
+        print_quoted(fd, src->value.s, ext == 'J');
+        return i;
+#endif /* USE_QUOTED */
+#ifdef USE_BLOB
+    case 'B': /* Base64 */
+    case 'A': /* Base85 */
+        if ((next_arg(src, SPE_ARG_TYPE_POINTER) < 0) ||
+            (print_blob(fd, src->value.p, spec, ext == 'A') < 0)) {
+            return -1;
+        }
+        return i;
+#endif /* USE_BLOB */
+#ifdef USE_BIGINT
+    case 'W': /* 128 bit integer, signed if followed by d */
+        if (next_arg(src, SPE_ARG_TYPE_POINTER) < 0) {
+            return -1;
+        }
+        print_u128(fd, src->value.p, spec->suffix[0] == 'd', spec);
+        return (spec->suffix[0] == 'd') ? i + 1 : i;
+#endif /* USE_BIGINT */
+    default:
+        break;
+    }
+
+#ifdef USE_CUSTOM_CONVERSION
+    if (((unsigned char)ext < 128U) && custom_conversions[(int)ext]) {
+        int used;
+
+        if (next_arg(src, SPE_ARG_TYPE_POINTER) < 0) {
+            return -1;
+        }
+        used = custom_conversions[(int)ext](fd, spec, src->value.p);
+        if (used < 0) {
+            return -1;
+        }
+        return i + used;
+    }
+#endif /* USE_CUSTOM_CONVERSION */
+
+    (void)fd;
+    (void)spec;
+    (void)src;
+    return -1;
+} /* pointer_extension */
+#endif
+
+
+/**
+ * Character classes used by the conversion parser.
+ */
+enum char_class_t {
+    CC_OTHER,  /* Not valid in a conversion */
+    CC_FLAG,   /* - + space # */
+    CC_ZERO,   /* 0, flag or digit depending on state */
+    CC_DIGIT,  /* 1-9 */
+    CC_STAR,   /* Width or precision given as parameter */
+    CC_DOT,    /* Precision follows */
+    CC_LENGTH, /* l */
+    CC_CONV,   /* Conversion character */
+    NUF_CHAR_CLASSES,
+};
+
+/**
+ * Parser states. Entering a state also decides what to do with the
+ * character that caused the transition.
+ */
+enum parse_state_t {
+    PS_FLAGS,      /* Directly after %, or after a flag */
+    PS_WIDTH,      /* Digit of minimal width */
+    PS_WIDTH_STAR, /* Minimal width as parameter */
+    PS_DOT,        /* Precision dot */
+    PS_PREC,       /* Digit of precision */
+    PS_PREC_STAR,  /* Precision as parameter */
+    PS_LENGTH,     /* Length modifier */
+    PS_CONV,       /* Conversion character found, done */
+    PS_ERROR,      /* Invalid conversion */
+    NUF_PARSE_STATES,
+};
+
+static const unsigned char char_class[128] = {
+    ['#'] = CC_FLAG,
+    ['0'] = CC_ZERO,
+    ['1'] = CC_DIGIT, ['2'] = CC_DIGIT, ['3'] = CC_DIGIT, ['4'] = CC_DIGIT,
+    ['5'] = CC_DIGIT, ['6'] = CC_DIGIT, ['7'] = CC_DIGIT, ['8'] = CC_DIGIT,
+    ['9'] = CC_DIGIT,
+    ['*'] = CC_STAR,
+    ['.'] = CC_DOT,
+    ['l'] = CC_LENGTH,
+    ['%'] = CC_CONV, ['c'] = CC_CONV, ['s'] = CC_CONV, ['d'] = CC_CONV,
+    ['u'] = CC_CONV, ['x'] = CC_CONV, ['X'] = CC_CONV, ['o'] = CC_CONV,
+    ['b'] = CC_CONV, ['f'] = CC_CONV, ['p'] = CC_CONV,
+};
+
+static const unsigned char parse_next[NUF_PARSE_STATES][NUF_CHAR_CLASSES] = {
+    /*                OTHER     FLAG      ZERO      DIGIT     STAR
+                      DOT       LENGTH    CONV */
+    [PS_FLAGS]      = {PS_ERROR, PS_FLAGS, PS_FLAGS, PS_WIDTH, PS_WIDTH_STAR,
+                       PS_DOT, PS_LENGTH, PS_CONV},
+    [PS_WIDTH]      = {PS_ERROR, PS_ERROR, PS_WIDTH, PS_WIDTH, PS_ERROR,
+                       PS_DOT, PS_LENGTH, PS_CONV},
+    [PS_WIDTH_STAR] = {PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR,
+                       PS_DOT, PS_LENGTH, PS_CONV},
+    [PS_DOT]        = {PS_ERROR, PS_ERROR, PS_PREC, PS_PREC, PS_PREC_STAR,
+                       PS_ERROR, PS_LENGTH, PS_CONV},
+    [PS_PREC]       = {PS_ERROR, PS_ERROR, PS_PREC, PS_PREC, PS_ERROR,
+                       PS_ERROR, PS_LENGTH, PS_CONV},
+    [PS_PREC_STAR]  = {PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR,
+                       PS_ERROR, PS_LENGTH, PS_CONV},
+    [PS_LENGTH]     = {PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR,
+                       PS_ERROR, PS_LENGTH, PS_CONV},
+    [PS_CONV]       = {PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR,
+                       PS_ERROR, PS_ERROR, PS_ERROR},
+    [PS_ERROR]      = {PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR, PS_ERROR,
+                       PS_ERROR, PS_ERROR, PS_ERROR},
+};
+
+/**
+ * \b parse_spec
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Parse flags, minimal width, precision, length modifier and conversion
+ * character following a %. Each character is classified by a table lookup
+ * and the next state is another table lookup. Width and precision given as
+ * parameter (*) are only flagged, since the caller owns the arguments.
+ *
+ * @param fmt The format string to use when formatting output.
+ * @param i Index in fmt string of the %.
+ * @param spec The parsed conversion specification.
+ *
+ * @retval >=0 Index in fmt string of the conversion character.
+ * @retval -1 on failure.
+ */
+static int
+parse_spec(const char *fmt, int i, struct spe_conv_spec *spec)
+{
+    enum parse_state_t state = PS_FLAGS;
+
+    spec->flags = 0;
+    spec->min_width = 0;
+    spec->precision = -1;
+    spec->long_modifier = 0;
+
+    while (1) {
+        const unsigned char c = (unsigned char)fmt[++i];
+
+        state = (enum parse_state_t)
+            parse_next[state][(c < 128U) ? char_class[c] : CC_OTHER];
+        switch (state) {
+        case PS_FLAGS:
+            spec->flags |= (c == '#') ? SPE_FLAG_ALT : SPE_FLAG_ZERO;
+            break;
+        case PS_WIDTH:
+            spec->min_width = spec->min_width * 10 + (c - '0');
+            break;
+        case PS_WIDTH_STAR:
+            spec->flags |= SPE_FLAG_WIDTH_STAR;
+            break;
+        case PS_DOT:
+            spec->precision = 0;
+            break;
+        case PS_PREC:
+            spec->precision = spec->precision * 10 + (c - '0');
+            break;
+        case PS_PREC_STAR:
+            spec->flags |= SPE_FLAG_PREC_STAR;
+            break;
+        case PS_LENGTH:
+            spec->long_modifier++;
+            break;
+        case PS_CONV:
+            spec->conversion = (char)c;
+            spec->suffix = &fmt[i + 1];
+            return i;
+        case PS_ERROR:
+        case NUF_PARSE_STATES:
+        default:
+            return -1;
+        }
+    }
+} /* parse_spec */
+
+
+/**
+ * \b int_precision
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Precision handed to the integer printers. The 0 flag without precision
+ * pads with zeros up to the minimal width, leaving room for a minus sign
+ * or 0x prefix.
+ *
+ * @param spec The parsed conversion specification.
+ * @param prefix_len Number of characters in front of the digits.
+ *
+ * @retval Minimum number of digits to print.
+ */
+static int
+int_precision(const struct spe_conv_spec *spec, int prefix_len)
+{
+    if (spec->precision >= 0) {
+        return spec->precision;
+    }
+    if (spec->flags & SPE_FLAG_ZERO) {
+        return spec->min_width - prefix_len;
+    }
+    return 0;
+} /* int_precision */
+
+
+/**
+ * \b conversion
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Conversion
+ * Format string resolver.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param fmt The format string to use when formatting output.
+ * @param i Index in fmt string we're trying to resolve.
+ * @param src Where the arguments come from.
+ *
+ * @retval >=0 Index in fmt string of the last character consumed.
+ * @retval -1 on failure.
+ */
+static int
+conversion(SPE_FILE *fd, const char *fmt, int i, struct arg_source *src)
+{
+    struct spe_conv_spec spec;
+    int precision;
+
+    if ((i = parse_spec(fmt, i, &spec)) < 0) {
+        return -1;
+    }
+    if (spec.flags & SPE_FLAG_WIDTH_STAR) {
+        if (next_arg(src, SPE_ARG_TYPE_INT) < 0) {
+            return -1;
+        }
+        /* Left adjustment is not supported, nor a negative blob length */
+        if (src->value.i < 0) {
+            return -1;
+        }
+        spec.min_width = src->value.i;
+    }
+    if (spec.flags & SPE_FLAG_PREC_STAR) {
+        if (next_arg(src, SPE_ARG_TYPE_INT) < 0) {
+            return -1;
+        }
+        spec.precision = src->value.i;
+        if (spec.precision < 0) {
+            spec.precision = -1;
+        }
+    }
+    if (spec.long_modifier > 1) {
+        return -1;
+    }
+
+    switch (spec.conversion) {
+    case '%': /* Plain % */
+        print_char(fd, '%');
+        return i;
+    case 'c': /* Character */
+        if (next_arg(src, SPE_ARG_TYPE_INT) < 0) {
+            return -1;
+        }
+#ifdef USE_UTF8
+        if (spec.long_modifier) { /* wint_t */
+            char utf8[4];
+
+            print_run(fd, utf8, utf8_encode(src->value.u, utf8));
+            return i;
+        }
+#endif
+        print_char(fd, (char)src->value.i);
+        return i;
+    case 's': /* String */
+#ifdef USE_UTF8
+        if (spec.long_modifier) {
+            if (next_arg(src, SPE_ARG_TYPE_POINTER) < 0) {
+                return -1;
+            }
+            print_wide(fd, src->value.p, spec.precision);
+            return i;
+        }
+#endif
+        if (next_arg(src, SPE_ARG_TYPE_STRING) < 0) {
+            return -1;
+        }
+#ifdef USE_UTF8
+        if (spec.precision >= 0) {
+            print_utf8(fd, src->value.s, spec.precision);
+            return i;
+        }
+#endif
+        print_string(fd, src->value.s);
+        return i;
+    case 'd': /* Signed integer and long */
+        if (spec.long_modifier) {
+            long number;
+
+            if (next_arg(src, SPE_ARG_TYPE_LONG) < 0) {
+                return -1;
+            }
+            number = src->value.l;
+            precision = int_precision(&spec, number < 0L);
+            print_sil(fd, number, spec.min_width, precision);
+        } else {
+            int number;
+
+            if (next_arg(src, SPE_ARG_TYPE_INT) < 0) {
+                return -1;
+            }
+            number = src->value.i;
+            precision = int_precision(&spec, number < 0);
+            print_si(fd, number, spec.min_width, precision);
+        }
+        return i;
+    case 'u': /* Unsigned integer and long */
+        precision = int_precision(&spec, 0);
+        if (spec.long_modifier) {
+            if (next_arg(src, SPE_ARG_TYPE_ULONG) < 0) {
+                return -1;
+            }
+            print_uil(fd, src->value.ul, spec.min_width, precision, 0);
+        } else {
+            if (next_arg(src, SPE_ARG_TYPE_UINT) < 0) {
+                return -1;
+            }
+            print_ui(fd, src->value.u, spec.min_width, precision, 0);
+        }
+        return i;
+    case 'x': /* Hex */
+    case 'X': /* Hex */
+    case 'o': /* Octal */
+    case 'b': /* Binary */
+        {
+            unsigned long number;
+            const char *prefix = NULL;
+            enum base_t base;
+
+            if (next_arg(src, spec.long_modifier ?
+                         SPE_ARG_TYPE_ULONG : SPE_ARG_TYPE_UINT) < 0) {
+                return -1;
+            }
+            number = spec.long_modifier ? src->value.ul : src->value.u;
+
+            switch (spec.conversion) {
+            case 'x':
+                base = BASE_HEX_LOWER_CASE;
+                prefix = "0x";
+                break;
+            case 'X':
+                base = BASE_HEX_UPPER_CASE;
+                prefix = "0X";
+                break;
+            case 'o':
+                base = BASE_OCTAL;
+                break;
+            default:
+                base = BASE_BINARY;
+                prefix = "0b";
+                break;
+            }
+            if (!(spec.flags & SPE_FLAG_ALT) || (number == 0UL)) {
+                prefix = NULL;
+            }
+            precision = int_precision(&spec, prefix ? 2 : 0);
+            print_pow2(fd, number, base, spec.min_width, precision, prefix);
+        }
+        return i;
+#ifdef USE_DOUBLE
+    case 'f':
+        if (next_arg(src, SPE_ARG_TYPE_DOUBLE) < 0) {
+            return -1;
+        }
+        print_d(fd, src->value.d, spec.min_width, spec.precision,
+                spec.flags & SPE_FLAG_ZERO);
+        return i;
+#endif /* USE_DOUBLE */
+    case 'p': /* Pointer, or pointer extensions */
+#ifdef POINTER_EXTENSIONS
+        if (is_pointer_extension(fmt[i + 1])) {
+            spec.suffix++;
+            return pointer_extension(fd, fmt[i + 1], &spec, src, i + 1);
+        }
+#endif
+        {
+            const void *pointer;
+
+            if (next_arg(src, SPE_ARG_TYPE_POINTER) < 0) {
+                return -1;
+            }
+            pointer = src->value.p;
+
+            if (pointer) {
+                print_pow2(fd, (unsigned long)pointer, BASE_HEX_LOWER_CASE,
+                           spec.min_width, 0, "0x");
+            } else {
+                print_pad(fd, spec.min_width, 0, 5, NULL);
+                print_string(fd, "(nil)");
+            }
+        }
+        return i;
+    default:
+        return -1;
+    }
+} /* conversion */
+
+
+/**
+ * \b render
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print fmt to fd, taking the arguments of the conversions from src.
+ * The text between conversions is printed a run at a time.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param fmt The format string to use when formatting output.
+ * @param src Where the arguments come from.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+static int
+render(SPE_FILE *fd, const char *fmt, struct arg_source *src)
+{
+    int i = 0;
+
+    while (fmt[i] && !fd->full) {
+        if (fmt[i] == '%') {
+            if ((i = conversion(fd, fmt, i, src)) < 0) {
+                return -1;
+            }
+            i++;
+        } else {
+            /* Text up to the next conversion in one go */
+            i += (int)print_text(fd, &fmt[i], '%');
+        }
+    }
+    return 0;
+} /* render */
+
+
+#ifdef USE_FINGERPRINT
+/**
+ * \b hash_bytes
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Mix len bytes into a 32 bit FNV-1a hash.
+ *
+ * Only included if USE_FINGERPRINT is defined.
+ *
+ * @param hash Hash so far.
+ * @param data The bytes.
+ * @param len Number of bytes.
+ *
+ * @retval The new hash.
+ */
+static unsigned long
+hash_bytes(unsigned long hash, const void *data, const size_t len)
+{
+    const unsigned char *bytes = data;
+    size_t k;
+
+    for (k = 0; k < len; k++) {
+        hash = ((hash ^ bytes[k]) * 16777619UL) & 0xffffffffUL;
+    }
+    return hash;
+} /* hash_bytes */
+
+
+/**
+ * \b hash_string
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Mix the characters of a string into the hash, and its end so that
+ * adjacent strings can't trade characters.
+ *
+ * Only included if USE_FINGERPRINT is defined.
+ *
+ * @param hash Hash so far.
+ * @param string The string, or NULL.
+ *
+ * @retval The new hash.
+ */
+static unsigned long
+hash_string(unsigned long hash, const char *string)
+{
+    size_t len = 0;
+
+    if (!string) {
+        return hash_bytes(hash, "\1", 1);
+    }
+    for (; string[len]; len++) {
+    }
+    return hash_bytes(hash, string, len + 1);
+} /* hash_string */
+
+
+#ifdef USE_UTF8
+/**
+ * \b hash_wide
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Mix the characters of a wide string into the hash as hash_string(),
+ * only the first precision ones if it is not negative, since no more of
+ * them are printed.
+ *
+ * Only included if USE_FINGERPRINT and USE_UTF8 are defined.
+ *
+ * @param hash Hash so far.
+ * @param string The wide string, or NULL.
+ * @param precision Most characters, -1 for all.
+ *
+ * @retval The new hash.
+ */
+static unsigned long
+hash_wide(unsigned long hash, const wchar_t *string, const int precision)
+{
+    size_t len = 0;
+
+    if (!string) {
+        return hash_bytes(hash, "\1", 1);
+    }
+    for (; string[len] && ((precision < 0) || (len < (size_t)precision));
+         len++) {
+    }
+    hash = hash_bytes(hash, string, len * sizeof(wchar_t));
+    return hash_bytes(hash, "", 1);
+} /* hash_wide */
+#endif /* USE_UTF8 */
+
+
+/**
+ * \b fingerprint
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Walk the conversions of fmt as render() does, fetching every argument
+ * and mixing it into hash, but printing nothing. Strings are hashed by
+ * their characters, binary data by its bytes and other arguments by
+ * value. Timestamps and durations are fetched but left out, they differ
+ * every time. The characters following a custom conversion are taken as
+ * text, since only the callback knows how many it uses.
+ *
+ * Only included if USE_FINGERPRINT is defined.
+ *
+ * @param fmt The format string.
+ * @param src Where the arguments come from.
+ * @param hash Hash so far, updated.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+static int
+fingerprint(const char *fmt, struct arg_source *src, unsigned long *hash)
+{
+    int i;
+
+    for (i = 0; fmt[i]; i++) {
+        struct spe_conv_spec spec;
+        enum spe_arg_type type;
+
+        if (fmt[i] != '%') {
+            continue;
+        }
+        if ((i = parse_spec(fmt, i, &spec)) < 0) {
+            return -1;
+        }
+        if (spec.flags & SPE_FLAG_WIDTH_STAR) {
+            if (next_arg(src, SPE_ARG_TYPE_INT) < 0) {
+                return -1;
+            }
+            spec.min_width = src->value.i;
+            *hash = hash_bytes(*hash, &src->value.i, sizeof(int));
+        }
+        if (spec.flags & SPE_FLAG_PREC_STAR) {
+            if (next_arg(src, SPE_ARG_TYPE_INT) < 0) {
+                return -1;
+            }
+            spec.precision = src->value.i;
+            *hash = hash_bytes(*hash, &src->value.i, sizeof(int));
+        }
+
+        switch (spec.conversion) {
+        case '%':
+            continue;
+        case 'c':
+            type = SPE_ARG_TYPE_INT;
+            break;
+        case 'd':
+            type = spec.long_modifier ? SPE_ARG_TYPE_LONG : SPE_ARG_TYPE_INT;
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'b':
+            type = spec.long_modifier ? SPE_ARG_TYPE_ULONG : SPE_ARG_TYPE_UINT;
+            break;
+#ifdef USE_DOUBLE
+        case 'f':
+            type = SPE_ARG_TYPE_DOUBLE;
+            break;
+#endif
+        case 's':
+#ifdef USE_UTF8
+            if (spec.long_modifier) {
+                if (next_arg(src, SPE_ARG_TYPE_POINTER) < 0) {
+                    return -1;
+                }
+                *hash = hash_wide(*hash, src->value.p, spec.precision);
+                continue;
+            }
+#endif
+            type = SPE_ARG_TYPE_STRING;
+            break;
+        case 'p':
+            type = SPE_ARG_TYPE_POINTER;
+#ifdef POINTER_EXTENSIONS
+            if (is_pointer_extension(fmt[i + 1])) {
+                switch (fmt[++i]) {
+#ifdef USE_TIMESTAMP
+                case 'T':
+                case 'D':
+                    if (next_arg(src, SPE_ARG_TYPE_U64) < 0) {
+                        return -1;
+                    }
+                    i++;
+                    continue;
+#endif
+#ifdef USE_QUOTED
+                case 'Q':
+                case 'J':
+                    type = SPE_ARG_TYPE_STRING;
+                    break;
+#endif
+#ifdef USE_BLOB
+                case 'B':
+                case 'A':
+                    if (next_arg(src, SPE_ARG_TYPE_POINTER) < 0) {
+                        return -1;
+                    }
+                    if (src->value.p && (spec.min_width > 0)) {
+                        *hash = hash_bytes(*hash, src->value.p,
+                                           (size_t)spec.min_width);
+                    }
+                    continue;
+#endif
+#ifdef USE_BIGINT
+                case 'W':
+                    if (next_arg(src, SPE_ARG_TYPE_POINTER) < 0) {
+                        return -1;
+                    }
+                    if (src->value.p) {
+                        *hash = hash_bytes(*hash, src->value.p,
+                                           sizeof(struct spe_u128));
+                    }
+                    if (fmt[i + 1] == 'd') {
+                        i++;
+                    }
+                    continue;
+#endif
+                default:
+                    break;
+                }
+            }
+#endif /* POINTER_EXTENSIONS */
+            break;
+        default:
+            return -1;
+        }
+
+        if (next_arg(src, type) < 0) {
+            return -1;
+        }
+        switch (type) {
+        case SPE_ARG_TYPE_INT:
+            *hash = hash_bytes(*hash, &src->value.i, sizeof(int));
+            break;
+        case SPE_ARG_TYPE_UINT:
+            *hash = hash_bytes(*hash, &src->value.u, sizeof(unsigned int));
+            break;
+        case SPE_ARG_TYPE_LONG:
+            *hash = hash_bytes(*hash, &src->value.l, sizeof(long));
+            break;
+        case SPE_ARG_TYPE_ULONG:
+            *hash = hash_bytes(*hash, &src->value.ul, sizeof(unsigned long));
+            break;
+        case SPE_ARG_TYPE_DOUBLE:
+#ifdef USE_DOUBLE
+            *hash = hash_bytes(*hash, &src->value.d, sizeof(double));
+#endif
+            break;
+        case SPE_ARG_TYPE_STRING:
+            *hash = hash_string(*hash, src->value.s);
+            break;
+        case SPE_ARG_TYPE_POINTER:
+        case SPE_ARG_TYPE_U64:
+        case NUF_SPE_ARG_TYPES:
+        default:
+            *hash = hash_bytes(*hash, &src->value.p, sizeof(const void *));
+            break;
+        }
+    }
+    return 0;
+} /* fingerprint */
+#endif /* USE_FINGERPRINT */
+
+
+/**@name General versions */
+/**@{*/
+/**
+ * \b spe_fputc
+ *
+ * Refer to fputc() in libc.
+ *
+ * @param c Character to print out.
+ * @param fd A pointer to the file descriptor.
+ *
+ * @retval c The character written.
+ */
+int
+spe_fputc(int c, SPE_FILE *fd)
+{
+    print_char(fd, (char)c);
+
+    return c;
+} /* spe_fputc */
+
+
+/**
+ * \b spe_fputs
+ *
+ * Refer to fputs() in libc. Unlike puts() no newline is added.
+ *
+ * @param s Zero-terminated string to print out.
+ * @param fd A pointer to the file descriptor.
+ *
+ * @retval 0 On success.
+ */
+int
+spe_fputs(const char *s, SPE_FILE *fd)
+{
+    return print_string(fd, s);
+} /* spe_fputs */
+
+
+/**
+ * \b spe_fwrite
+ *
+ * Refer to fwrite() in libc. Like spe_fputs(), but the length is given,
+ * so a \0 is printed too. A string is copied into in one go.
+ *
+ * @param ptr Data to print out.
+ * @param size Size of each item.
+ * @param nmemb Number of items.
+ * @param fd A pointer to the file descriptor.
+ *
+ * @retval nmemb The number of items.
+ */
+size_t
+spe_fwrite(const void *ptr, size_t size, size_t nmemb, SPE_FILE *fd)
+{
+    print_run(fd, (const char *)ptr, size * nmemb);
+
+    return nmemb;
+} /* spe_fwrite */
+
+
+#ifdef USE_BIGINT
+/**
+ * \b spe_fput_bigint
+ *
+ * Print an unsigned integer of any width up to SPE_BIGINT_MAX_WORDS
+ * words in decimal, a chunk of digits per division pass, see %pW.
+ *
+ * Only included if USE_BIGINT is defined.
+ *
+ * @param fd A pointer to the file descriptor.
+ * @param words The number, least significant 32 bit word first.
+ * @param nuf_words Number of words.
+ *
+ * @retval 0 On success.
+ * @retval -1 If there are no words or more than SPE_BIGINT_MAX_WORDS.
+ */
+int
+spe_fput_bigint(SPE_FILE *fd, const uint32_t *words, size_t nuf_words)
+{
+    big_limb limbs[SPE_BIGINT_MAX_WORDS * LIMBS_PER_WORD];
+    char digits[BIG_DIGITS + 1];
+    const struct spe_conv_spec spec = { .precision = -1 };
+    size_t k;
+    int part;
+
+    if ((nuf_words == 0) || (nuf_words > SPE_BIGINT_MAX_WORDS)) {
+        return -1;
+    }
+    for (k = 0; k < nuf_words; k++) {
+        for (part = 0; part < LIMBS_PER_WORD; part++) {
+            limbs[k * LIMBS_PER_WORD + (size_t)part] =
+                (big_limb)(words[k] >> (part * LIMB_BITS));
+        }
+    }
+    digits[BIG_DIGITS] = '\0';
+    print_big(fd, limbs, (int)(nuf_words * LIMBS_PER_WORD), 0, &spec,
+              &digits[BIG_DIGITS]);
+
+    return 0;
+} /* spe_fput_bigint */
+#endif /* USE_BIGINT */
+
+
+#ifdef USE_CUSTOM_CONVERSION
+/**
+ * \b spe_register_conversion
+ *
+ * Register a custom conversion used as %p followed by the character c.
+ * The argument is always a pointer, which keeps gcc's format checking
+ * happy. Register all conversions at startup, the table is not protected
+ * against concurrent updates.
+ *
+ * @param c Character following %p, must not be a built in one.
+ * @param fn The conversion function, NULL to remove a registration.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int
+spe_register_conversion(char c, spe_conv_fn fn)
+{
+    if (((unsigned char)c == 0U) || ((unsigned char)c >= 128U)) {
+        return -1;
+    }
+    if (is_builtin_extension(c)) {
+        return -1;
+    }
+    custom_conversions[(int)c] = fn;
+
+    return 0;
+} /* spe_register_conversion */
+#endif /* USE_CUSTOM_CONVERSION */
+
+
+/**
+ * \b spe_fprintf
+ *
+ * Refer to fprintf() in libc.
+ *
+ * @param fd A pointer to the file descriptor.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int
+spe_fprintf(SPE_FILE *fd, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_vfprintf(fd, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_fprintf */
+
+
+/**
+ * \b spe_printf
+ *
+ * Refer to printf() in libc.
+ * Note that spe_stdout must have been defined.
+ *
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int
 spe_printf(const char *fmt, ...)
 {
     va_list ap;
@@ -644,7 +2950,8 @@ spe_snprintf(char *str, const size_t size, const char *fmt, ...)
 int
 spe_vfprintf(SPE_FILE *fd, const char *fmt, va_list ap)
 {
-    int ret = 0;
+    int ret;
+    struct arg_source src;
     /**
      * Problems when compiling on a X86/64 which is described here:
      * Solution is to use a copy, which seems to solve the issue on both
@@ -654,16 +2961,8 @@ spe_vfprintf(SPE_FILE *fd, const char *fmt, va_list ap)
     va_list ap_copy;
     va_copy(ap_copy, ap);
 
-    for (int i = 0; fmt[i]; i++) {
-        if (fmt[i] == '%') {
-            if ((i = conversion(fd, fmt, i, &ap_copy)) < 0) {
-                ret = -1;
-                break;
-            }
-        } else {
-            print_char(fd, fmt[i]);
-        }
-    }
+    src.ap = &ap_copy;
+    ret = render(fd, fmt, &src);
     va_end(ap_copy);
     return ret;
 } /* spe_vfprintf */
@@ -701,6 +3000,7 @@ spe_vprintf(const char *fmt, va_list ap)
  * @param ap A list of parameters in va_list format.
  *
  * @retval >=0 Number of characters written, including terminating \0.
+ *          0 if size is 0.
  * @retval -1 On failure.
  */
 
@@ -712,8 +3012,12 @@ spe_vsnprintf(char *str, const size_t size, const char *fmt, va_list ap)
         .str = str,
         .max = size,
         .curr = 0,
+        .full = (size <= 1),
     };
 
+    if (size == 0) {
+        return 0;
+    }
     if (spe_vfprintf(&strfd, fmt, ap) < 0) {
         return -1;
     }
@@ -722,4 +3026,300 @@ spe_vsnprintf(char *str, const size_t size, const char *fmt, va_list ap)
     return (int)strfd.curr;
 } /* spe_vsnprintf */
 
+
+#ifdef USE_TIMESTAMP
+/**
+ * \b spe_vsnprintf_cache
+ *
+ * Like spe_vsnprintf(), but %pT uses a cache owned by the caller instead
+ * of one that starts empty each call. For outputs that format each line
+ * into a buffer of their own first, such as a tee, so that their
+ * timestamps get the same cache hits as a file descriptor. The cache must
+ * not be shared by calls that can interrupt each other.
+ *
+ * Only included if USE_TIMESTAMP is defined.
+ *
+ * @param str Pointer to string to be written to.
+ * @param size Maximum number of characters to be written to the string,
+ *          including terminating \0.
+ * @param cache Timestamp cache, zeroed before first use.
+ * @param fmt Format string for formatting the text.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval >=0 Number of characters written, including terminating \0.
+ *          0 if size is 0.
+ * @retval -1 On failure.
+ */
+int
+spe_vsnprintf_cache(char *str, const size_t size,
+                    struct spe_time_cache *cache, const char *fmt, va_list ap)
+{
+    SPE_FILE strfd = {
+        .putc = NULL,
+        .str = str,
+        .max = size,
+        .curr = 0,
+        .full = (size <= 1),
+        .tcache = *cache,
+    };
+    int failed;
+
+    if (size == 0) {
+        return 0;
+    }
+    failed = (spe_vfprintf(&strfd, fmt, ap) < 0);
+    *cache = strfd.tcache;
+    if (failed) {
+        return -1;
+    }
+    strfd.str[strfd.curr++] = '\0';
+
+    return (int)strfd.curr;
+} /* spe_vsnprintf_cache */
+
+
+/**
+ * \b spe_snprintf_cache
+ *
+ * Like spe_snprintf(), with a timestamp cache, see spe_vsnprintf_cache().
+ *
+ * Only included if USE_TIMESTAMP is defined.
+ *
+ * @param str Pointer to string to be written to.
+ * @param size Maximum number of characters to be written to the string,
+ *          including terminating \0.
+ * @param cache Timestamp cache, zeroed before first use.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval >=0 Number of characters written, including terminating \0.
+ * @retval -1 On failure.
+ */
+int
+spe_snprintf_cache(char *str, const size_t size,
+                   struct spe_time_cache *cache, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_vsnprintf_cache(str, size, cache, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_snprintf_cache */
+#endif /* USE_TIMESTAMP */
+
+/**@}*/
+
+
+#ifdef USE_FINGERPRINT
+/**@name Fingerprint */
+/**@{*/
+/**
+ * \b spe_vfingerprint
+ *
+ * Fingerprint of what fmt and its arguments would print, without printing
+ * it: a hash of the format string pointer and the arguments, see
+ * fingerprint(). Two calls with the same format string and arguments have
+ * the same fingerprint, whatever the timestamps in them. Used to find
+ * repeated lines cheaply, the cost is the walk of fmt and the hashing of
+ * strings, none of the digit conversions.
+ *
+ * Only included if USE_FINGERPRINT is defined.
+ *
+ * @param fmt Format string for formatting the text.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval The fingerprint, 32 bits. The arguments up to a bad conversion
+ *          if fmt is invalid.
+ */
+unsigned long
+spe_vfingerprint(const char *fmt, va_list ap)
+{
+    unsigned long hash = 2166136261UL;
+    struct arg_source src;
+    va_list ap_copy;
+
+    va_copy(ap_copy, ap);
+    src.ap = &ap_copy;
+    hash = hash_bytes(hash, &fmt, sizeof(fmt));
+    (void)fingerprint(fmt, &src, &hash);
+    va_end(ap_copy);
+
+    return hash;
+} /* spe_vfingerprint */
+
+/**@}*/
+#endif /* USE_FINGERPRINT */
+
+
+#ifdef USE_ARG_PACK
+/**@name Argument pack versions */
+/**@{*/
+/**
+ * \b spe_fprintf_args
+ *
+ * As spe_fprintf(), with the arguments taken from an array instead of a
+ * va_list. The same pack can be printed any number of times, to different
+ * file descriptors or with different formats, and can be kept for printing
+ * later as long as the strings and pointers in it stay valid.
+ *
+ * @param fd A pointer to the file descriptor.
+ * @param fmt Format string for formatting the text.
+ * @param args The arguments, see struct spe_arg.
+ * @param nuf_args Number of arguments in args.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure, also if an argument is missing or of the wrong
+ *          type for its conversion.
+ */
+int
+spe_fprintf_args(SPE_FILE *fd, const char *fmt, const struct spe_arg *args,
+                 size_t nuf_args)
+{
+    struct arg_source src = {
+        .ap = NULL,
+        .next = args,
+        .end = &args[nuf_args],
+    };
+
+    return render(fd, fmt, &src);
+} /* spe_fprintf_args */
+
+
+/**
+ * \b spe_snprintf_args
+ *
+ * As spe_snprintf(), with the arguments taken from an array instead of a
+ * va_list, see spe_fprintf_args().
+ *
+ * @param str Pointer to string to be written to.
+ * @param size Maximum number of characters to be written to the string,
+ *          including terminating \0.
+ * @param fmt Format string for formatting the text.
+ * @param args The arguments, see struct spe_arg.
+ * @param nuf_args Number of arguments in args.
+ *
+ * @retval >=0 Number of characters written, including terminating \0.
+ *          0 if size is 0.
+ * @retval -1 On failure.
+ */
+int
+spe_snprintf_args(char *str, const size_t size, const char *fmt,
+                  const struct spe_arg *args, size_t nuf_args)
+{
+    SPE_FILE strfd = {
+        .putc = NULL,
+        .str = str,
+        .max = size,
+        .curr = 0,
+        .full = (size <= 1),
+    };
+
+    if (size == 0) {
+        return 0;
+    }
+    if (spe_fprintf_args(&strfd, fmt, args, nuf_args) < 0) {
+        return -1;
+    }
+    strfd.str[strfd.curr++] = '\0';
+
+    return (int)strfd.curr;
+} /* spe_snprintf_args */
+
+
+/**
+ * \b spe_arg_length
+ *
+ * Number of characters the argument prints as with a plain conversion,
+ * %d, %u, %x, %X, %o, %b, %c or %s, counted without printing it.
+ * Digits are counted as the conversions do. For laying out columns, see
+ * spe_table.c.
+ *
+ * @param arg The argument.
+ * @param conversion The conversion character, the l modifier follows from
+ *          the type of arg.
+ *
+ * @retval >=0 Number of characters, 0 for a NULL string.
+ * @retval -1 If arg can't be printed with conversion.
+ */
+int
+spe_arg_length(const struct spe_arg *arg, const char conversion)
+{
+    unsigned long number;
+    int neg = 0;
+    int len, shift;
+
+    switch (arg->type) {
+    case SPE_ARG_TYPE_STRING:
+        if (conversion != 's') {
+            return -1;
+        }
+        for (len = 0; arg->v.s && arg->v.s[len]; len++) {
+        }
+#ifdef USE_UTF8
+        {
+            int points = INT_MAX;
+
+            utf8_prefix(arg->v.s, (size_t)len, &points);
+            len = points;
+        }
+#endif
+        return len;
+    case SPE_ARG_TYPE_INT:
+    case SPE_ARG_TYPE_UINT:
+        {
+            const unsigned int u = (arg->type == SPE_ARG_TYPE_INT) ?
+                (unsigned int)arg->v.i : arg->v.u;
+
+            if (conversion == 'c') {
+                return 1;
+            }
+            neg = (conversion == 'd') && (u > (unsigned int)INT_MAX);
+            number = neg ? 0U - u : u;
+        }
+        break;
+    case SPE_ARG_TYPE_LONG:
+    case SPE_ARG_TYPE_ULONG:
+        {
+            const unsigned long ul = (arg->type == SPE_ARG_TYPE_LONG) ?
+                (unsigned long)arg->v.l : arg->v.ul;
+
+            neg = (conversion == 'd') && (ul > (unsigned long)LONG_MAX);
+            number = neg ? 0UL - ul : ul;
+        }
+        break;
+    case SPE_ARG_TYPE_U64:
+    case SPE_ARG_TYPE_DOUBLE:
+    case SPE_ARG_TYPE_POINTER:
+    case NUF_SPE_ARG_TYPES:
+    default:
+        return -1;
+    }
+
+    switch (conversion) {
+    case 'd':
+    case 'u':
+        return neg + decimal_digits(number);
+    case 'x':
+    case 'X':
+        shift = 4;
+        break;
+    case 'o':
+        shift = 3;
+        break;
+    case 'b':
+        shift = 1;
+        break;
+    default:
+        return -1;
+    }
+    if (number == 0UL) {
+        return 1;
+    }
+    return (significant_bits(number) + shift - 1) / shift;
+} /* spe_arg_length */
+
 /**@}*/
+#endif /* USE_ARG_PACK */
@@ -32,6 +32,25 @@ extern "C" {
 #include <stdarg.h>
 
 #include <stddef.h> /* size_t */
+#ifdef USE_BIGINT
+#include <stdint.h>
+#endif
+
+#ifdef USE_TIMESTAMP
+/**
+ * Cache of the last date and hour rendered by a %pT conversion.
+ * Lives in the file descriptor so consecutive log lines within the same
+ * hour only need to convert minutes, seconds and fraction. Since it is
+ * written by %pT, %pT on a file descriptor shared between an interrupt
+ * handler and a task, or between tasks, is not reentrant. Outputs that
+ * format into a buffer first keep one of their own and pass it to
+ * spe_vsnprintf_cache().
+ */
+struct spe_time_cache {
+    unsigned long hour; /*!< Hours since epoch plus one, 0 when empty */
+    char prefix[14];    /*!< Rendered "YYYY-MM-DDThh:" */
+};
+#endif /* USE_TIMESTAMP */
 
 /**
  * File descriptor declaration. Use macro SPE_FILE for declaration.\n
@@ -43,6 +62,14 @@ struct spe_fd {
     char *str;            /*!< String to store to for snprintf */
     size_t max;           /*!< Max number of chars in that string */
     size_t curr;          /*!< Current index in that string */
+    int full;             /*!< Non-zero once a character didn't fit in str
+                               and there is no callback, nothing more
+                               will be printed */
+#ifdef USE_TIMESTAMP
+    struct spe_time_cache tcache; /*!< Last rendered timestamp prefix,
+                                       written by %pT, see
+                                       struct spe_time_cache */
+#endif
 };
 
 /**
@@ -50,6 +77,100 @@ struct spe_fd {
  */
 #define SPE_FILE struct spe_fd
 
+/**
+ * Flags of a conversion specification, see struct spe_conv_spec.
+ */
+#define SPE_FLAG_ALT        0x08 /*!< '#' Alternate form */
+#define SPE_FLAG_ZERO       0x10 /*!< '0' Pad with zeros */
+#define SPE_FLAG_WIDTH_STAR 0x20 /*!< Width given as parameter */
+#define SPE_FLAG_PREC_STAR  0x40 /*!< Precision given as parameter */
+
+/**
+ * Parsed conversion specification. Given to custom conversions.
+ */
+struct spe_conv_spec {
+    int flags;          /*!< SPE_FLAG_* */
+    int min_width;      /*!< Minimum field width, 0 if not given */
+    int precision;      /*!< Precision, -1 if not given */
+    int long_modifier;  /*!< Number of l modifiers given */
+    char conversion;    /*!< Conversion character */
+    const char *suffix; /*!< Format string after the conversion character */
+};
+
+/**
+ * Custom conversion callback, see spe_register_conversion().
+ * Writes the pointed to argument to fd, for instance with spe_fputs() or
+ * spe_fprintf(). Returns the number of characters used from spec->suffix,
+ * or -1 on failure.
+ */
+typedef int (*spe_conv_fn)(SPE_FILE *fd, const struct spe_conv_spec *spec,
+                           const void *arg);
+
+#ifdef USE_BIGINT
+/**
+ * 128 bit integer printed by %pW, unsigned, and %pWd, signed. Has the
+ * layout of an `__int128` on a little endian target, so a pointer to one
+ * of those can be given instead.
+ */
+struct spe_u128 {
+    unsigned long long lo;  /*!< Low 64 bits */
+    unsigned long long hi;  /*!< High 64 bits, sign bit on top for %pWd */
+};
+
+/** Most 32 bit words of an integer given to spe_fput_bigint() */
+#ifndef SPE_BIGINT_MAX_WORDS
+#define SPE_BIGINT_MAX_WORDS 8
+#endif
+#endif /* USE_BIGINT */
+
+/**
+ * Type of an argument in a pack, see struct spe_arg.
+ */
+enum spe_arg_type {
+    SPE_ARG_TYPE_INT,     /*!< int, for %d, %c and * */
+    SPE_ARG_TYPE_UINT,    /*!< unsigned int, for %u, %x, %o and %b */
+    SPE_ARG_TYPE_LONG,    /*!< long, for %ld */
+    SPE_ARG_TYPE_ULONG,   /*!< unsigned long, for %lu, %lx, %lo and %lb */
+    SPE_ARG_TYPE_U64,     /*!< unsigned long long by value, for %pT and %pD */
+    SPE_ARG_TYPE_DOUBLE,  /*!< double, for %f */
+    SPE_ARG_TYPE_STRING,  /*!< const char *, for %s */
+    SPE_ARG_TYPE_POINTER, /*!< const void *, for %p and custom conversions */
+    NUF_SPE_ARG_TYPES,
+};
+
+/**
+ * One argument of a pack given to spe_fprintf_args(). Use the SPE_ARG_*()
+ * initialisers below.
+ */
+struct spe_arg {
+    enum spe_arg_type type;     /*!< Which member of v is set */
+    union spe_arg_value {
+        int i;                  /*!< SPE_ARG_TYPE_INT */
+        unsigned int u;         /*!< SPE_ARG_TYPE_UINT */
+        long l;                 /*!< SPE_ARG_TYPE_LONG */
+        unsigned long ul;       /*!< SPE_ARG_TYPE_ULONG */
+        unsigned long long u64; /*!< SPE_ARG_TYPE_U64 */
+        double d;               /*!< SPE_ARG_TYPE_DOUBLE */
+        const char *s;          /*!< SPE_ARG_TYPE_STRING */
+        const void *p;          /*!< SPE_ARG_TYPE_POINTER */
+    } v;                        /*!< The value */
+};
+
+#define SPE_ARG_INT(x)     { .type = SPE_ARG_TYPE_INT, .v = { .i = (x) } }
+#define SPE_ARG_UINT(x)    { .type = SPE_ARG_TYPE_UINT, .v = { .u = (x) } }
+#define SPE_ARG_LONG(x)    { .type = SPE_ARG_TYPE_LONG, .v = { .l = (x) } }
+#define SPE_ARG_ULONG(x)   { .type = SPE_ARG_TYPE_ULONG, .v = { .ul = (x) } }
+#define SPE_ARG_U64(x)     { .type = SPE_ARG_TYPE_U64, .v = { .u64 = (x) } }
+#define SPE_ARG_DOUBLE(x)  { .type = SPE_ARG_TYPE_DOUBLE, .v = { .d = (x) } }
+#define SPE_ARG_STRING(x)  { .type = SPE_ARG_TYPE_STRING, .v = { .s = (x) } }
+#define SPE_ARG_POINTER(x) { .type = SPE_ARG_TYPE_POINTER, .v = { .p = (x) } }
+
+#ifdef USE_TIMESTAMP
+#define SPE_TIME_CACHE_SETUP .tcache = { 0, { 0 } },
+#else
+#define SPE_TIME_CACHE_SETUP
+#endif
+
 /**
  * Register the print out one character callback function.
  * The callback function is defined as \code void putc(char c) \endcode.
@@ -60,6 +181,8 @@ struct spe_fd {
         .str  = NULL,                           \
         .max  = 0,                              \
         .curr = 0,                              \
+        .full = 0,                              \
+        SPE_TIME_CACHE_SETUP                    \
     }
 
 
@@ -88,11 +211,34 @@ extern SPE_FILE *spe_stderr;
  * 's': String
  * 'd': Signed integer and long
  * 'u': Unsigned integer and long
- * 'l': long modifier, used with u and d
+ * 'l': long modifier, used with u, d, x, X, o and b
  * 'x': Hex, takes unsigned integer
+ * 'X': Hex with upper case digits, takes unsigned integer
+ * 'o': Octal, takes unsigned integer
+ * 'b': Binary, takes unsigned integer
+ * 'p': Pointer
+ * '#': Flag adding 0x, 0X or 0b prefix to x, X and b
  * 'f': Double, floating point, if support is compiled in
+ * 'pT': ISO-8601 timestamp, if support is compiled in
+ * 'pD': Duration, if support is compiled in
+ * 'pQ': String quoted and escaped as a C literal, if support is compiled in
+ * 'pJ': String quoted and escaped as JSON, if support is compiled in
+ * 'pB': Base64 of width bytes, if support is compiled in
+ * 'pA': Base85 (Z85) of width bytes, if support is compiled in
+ * 'pW': 128 bit integer, 'pWd' signed, if support is compiled in
+ * 'p?': Custom conversion, if support is compiled in
  */
 
+int spe_fputc(int c, SPE_FILE *fd);
+int spe_fputs(const char *s, SPE_FILE *fd);
+size_t spe_fwrite(const void *ptr, size_t size, size_t nmemb, SPE_FILE *fd);
+#ifdef USE_BIGINT
+int spe_fput_bigint(SPE_FILE *fd, const uint32_t *words, size_t nuf_words);
+#endif
+#ifdef USE_CUSTOM_CONVERSION
+int spe_register_conversion(char c, spe_conv_fn fn);
+#endif
+
 int spe_fprintf(SPE_FILE *fd, const char *fmt, ...)
     __attribute__((__format__(__printf__, 2, 3)));
 int spe_printf(const char *fmt, ...)
@@ -105,6 +251,25 @@ int spe_vprintf(const char *fmt, va_list ap)
     __attribute__((__format__(__printf__, 1, 0)));
 int spe_vsnprintf(char *str, const size_t size, const char *fmt, va_list ap)
     __attribute__((__format__(__printf__, 3, 0)));
+#ifdef USE_TIMESTAMP
+int spe_snprintf_cache(char *str, const size_t size,
+                       struct spe_time_cache *cache, const char *fmt, ...)
+    __attribute__((__format__(__printf__, 4, 5)));
+int spe_vsnprintf_cache(char *str, const size_t size,
+                        struct spe_time_cache *cache, const char *fmt,
+                        va_list ap)
+    __attribute__((__format__(__printf__, 4, 0)));
+#endif
+#ifdef USE_ARG_PACK
+int spe_fprintf_args(SPE_FILE *fd, const char *fmt,
+                     const struct spe_arg *args, size_t nuf_args);
+int spe_snprintf_args(char *str, const size_t size, const char *fmt,
+                      const struct spe_arg *args, size_t nuf_args);
+int spe_arg_length(const struct spe_arg *arg, const char conversion);
+#endif
+#ifdef USE_FINGERPRINT
+unsigned long spe_vfingerprint(const char *fmt, va_list ap);
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_repeat.c
+ *
+ * Output that collapses repeated lines.
+ *
+ * A fault that keeps happening prints the same line thousands of times,
+ * which fills the UART and starves the tasks waiting for it. Here every
+ * line is first fingerprinted with spe_vfingerprint(), from the format
+ * string pointer and the arguments without formatting anything, and looked
+ * up in a table of the lines recently printed. A line with the same
+ * fingerprint printed less than a window of time ago is only counted.
+ * When it comes again after the window, or its entry is taken by another
+ * line, the count is printed as a summary before the line:
+ *
+ * \code
+ * repeated 4711 times: ADC timeout on channel 3\n
+ * \endcode
+ *
+ * The summary shows the line as it was printed. Each entry keeps its first
+ * SPE_REPEAT_LINE - 1 characters, the line is formatted into the entry and
+ * printed from there, so it is formatted once unless it is longer. Call
+ * spe_repeat_flush() now and then, from the idle loop or a timer, so that
+ * a storm that has stopped gets its summary too.
+ *
+ * \code
+ * static struct spe_repeat_entry recent[16];
+ * static struct spe_repeat log = SPE_REPEAT_SETUP(&uart, recent,
+ *                                                 1000, uptime_ms);
+ *
+ * spe_repeat_printf(&log, "ADC timeout on channel %d\n", ch);
+ * \endcode
+ *
+ * The table is direct mapped on the fingerprint, so a lookup is one
+ * comparison. Timestamps in a line don't make it differ. An output must
+ * not be used concurrently.
+ *
+ * Requires spe_printf.c compiled with USE_FINGERPRINT.
+ */
+
+#include <stdarg.h>
+
+#include "spe_printf.h"
+#include "spe_repeat.h"
+
+
+/**
+ * \b summary
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print how many times the line of entry was suppressed, and start
+ * counting again. A newline is added if the kept line has none, when it
+ * was cut short or printed without one.
+ *
+ * @param rep The output.
+ * @param entry Line with suppressed repeats.
+ */
+static void
+summary(struct spe_repeat *rep, struct spe_repeat_entry *entry)
+{
+    size_t len = 0;
+
+    while (entry->line[len]) {
+        len++;
+    }
+    spe_fprintf(rep->out, "repeated %lu times: %s%s", entry->count,
+                entry->line,
+                (len && (entry->line[len - 1] == '\n')) ? "" : "\n");
+    entry->count = 0;
+} /* summary */
+
+
+/**
+ * \b spe_repeat_printf
+ *
+ * Print a line, unless the same line was printed less than the window of
+ * the output ago.
+ *
+ * @param rep The output.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval 1 If the line was printed.
+ * @retval 0 If it was a repeat, and only counted.
+ * @retval -1 On failure.
+ */
+int
+spe_repeat_printf(struct spe_repeat *rep, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_repeat_vprintf(rep, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_repeat_printf */
+
+
+/**
+ * \b spe_repeat_vprintf
+ *
+ * Variadic version of spe_repeat_printf().
+ *
+ * @param rep The output.
+ * @param fmt Format string for formatting the text.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval 1 If the line was printed.
+ * @retval 0 If it was a repeat, and only counted.
+ * @retval -1 On failure.
+ */
+int
+spe_repeat_vprintf(struct spe_repeat *rep, const char *fmt, va_list ap)
+{
+    const unsigned long fingerprint = spe_vfingerprint(fmt, ap);
+    const unsigned long now = rep->now();
+    struct spe_repeat_entry *entry = &rep->table[fingerprint % rep->size];
+    int len;
+
+    if (entry->fmt && (entry->fingerprint == fingerprint) &&
+        ((now - entry->since) < rep->window)) {
+        entry->count++;
+        return 0;
+    }
+    if (entry->fmt && entry->count) {
+        summary(rep, entry);
+    }
+    entry->fmt = fmt;
+    entry->fingerprint = fingerprint;
+    entry->since = now;
+    entry->count = 0;
+
+    /* Includes the terminating \0, the size of line when cut short */
+#ifdef USE_TIMESTAMP
+    len = spe_vsnprintf_cache(entry->line, sizeof(entry->line), &rep->tcache,
+                              fmt, ap);
+#else
+    len = spe_vsnprintf(entry->line, sizeof(entry->line), fmt, ap);
+#endif
+    if (len < 0) {
+        return -1;
+    }
+    if ((size_t)len < sizeof(entry->line)) {
+        spe_fputs(entry->line, rep->out);
+    } else if (spe_vfprintf(rep->out, fmt, ap) < 0) {
+        return -1;
+    }
+    return 1;
+} /* spe_repeat_vprintf */
+
+
+/**
+ * \b spe_repeat_flush
+ *
+ * Print the summaries of lines whose window has passed, and forget them,
+ * so the next time they are printed in full.
+ *
+ * @param rep The output.
+ *
+ * @retval Number of summaries printed.
+ */
+int
+spe_repeat_flush(struct spe_repeat *rep)
+{
+    const unsigned long now = rep->now();
+    int printed = 0;
+    size_t i;
+
+    for (i = 0; i < rep->size; i++) {
+        struct spe_repeat_entry *entry = &rep->table[i];
+
+        if (!entry->fmt || ((now - entry->since) < rep->window)) {
+            continue;
+        }
+        if (entry->count) {
+            summary(rep, entry);
+            printed++;
+        }
+        entry->fmt = NULL;
+    }
+    return printed;
+} /* spe_repeat_flush */
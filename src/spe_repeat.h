@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_REPEAT_H
+#define SPE_REPEAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stddef.h> /* size_t */
+
+#include "spe_printf.h"
+
+#ifndef SPE_REPEAT_LINE
+#define SPE_REPEAT_LINE 64 /*!< Characters of a line kept for its summary */
+#endif
+
+/**
+ * A line recently printed. Don't modify directly.
+ */
+struct spe_repeat_entry {
+    const char *fmt;            /*!< Format string of the line, NULL if free */
+    unsigned long fingerprint;  /*!< spe_vfingerprint() of the line */
+    unsigned long since;        /*!< Time the line was last printed */
+    unsigned long count;        /*!< Repeats suppressed since then */
+    char line[SPE_REPEAT_LINE]; /*!< The line as printed, maybe cut short */
+};
+
+/**
+ * Output suppressing repeated lines. Use macro SPE_REPEAT_SETUP for
+ * initialisation.\n
+ * Don't modify directly.
+ */
+struct spe_repeat {
+    SPE_FILE *out;                  /*!< Where lines go */
+    struct spe_repeat_entry *table; /*!< Lines recently printed */
+    size_t size;                    /*!< Entries in table */
+    unsigned long window;           /*!< Time a repeat is suppressed */
+    unsigned long (*now)(void);     /*!< Current time, any unit */
+#ifdef USE_TIMESTAMP
+    struct spe_time_cache tcache;   /*!< %pT cache of the lines */
+#endif
+};
+
+/**
+ * Set up an output to fd from a zeroed array of struct spe_repeat_entry,
+ * the time a line is suppressed after being printed and a function giving
+ * the current time in the same unit.
+ */
+#define SPE_REPEAT_SETUP(fd, table_array, window_time, now_fn)         \
+    {                                                                  \
+        .out = fd,                                                     \
+        .table = table_array,                                          \
+        .size = sizeof(table_array) / sizeof((table_array)[0]),        \
+        .window = window_time,                                         \
+        .now = now_fn,                                                 \
+        SPE_TIME_CACHE_SETUP                                           \
+    }
+
+int spe_repeat_printf(struct spe_repeat *rep, const char *fmt, ...)
+    __attribute__((__format__(__printf__, 2, 3)));
+int spe_repeat_vprintf(struct spe_repeat *rep, const char *fmt, va_list ap)
+    __attribute__((__format__(__printf__, 2, 0)));
+int spe_repeat_flush(struct spe_repeat *rep);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_REPEAT_H */
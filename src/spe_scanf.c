@@ -0,0 +1,1152 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_scanf.c
+ *
+ * Input functions, spe_sscanf() and spe_strtol() et al, with the same
+ * conversions as spe_printf().
+ *
+ * Where the target can load 64 bits little endian, decimal and hex digits
+ * are parsed eight at a time. The eight characters are loaded as one word,
+ * checked to all be digits with a few additions and masks, and converted
+ * with three multiplications (SWAR, SIMD within a register). The remaining
+ * digits are parsed one by one. A word must never be loaded beyond the end
+ * of the string, so the functions first take the length of the string.
+ *
+ * Floating point, if compiled in with USE_DOUBLE, is rounded to the
+ * nearest double, ties to even, from the first 19 significant digits.
+ * Numbers whose digits fit in 53 bits with an exponent of at most 22 take
+ * a single double multiplication or division. Those operands are exact,
+ * since every power of ten up to 1e22 is an exact double. Other numbers
+ * are scaled in 128 bits and rounded once. For exponents from -27 to 27
+ * this is exact, by 5^k and a long division by 5^k. Further out, a power
+ * of ten is rounded down to 128 bits, so the result can only round the
+ * wrong way within about 2^-120 of a halfway point between two doubles.
+ * The tests compare with libc strtod() on random %.17g strings and have
+ * found no such number. Digits after the 19th are dropped, so longer
+ * numbers can come out one unit in the last place low. inf and nan are
+ * not parsed, and errno is only set on overflow.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "spe_scanf.h"
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SPE_SWAR
+#endif
+
+#ifdef SPE_SWAR
+#define ONES  0x0101010101010101ULL /* 1 in every byte */
+#define HIGHS 0x8080808080808080ULL /* Top bit of every byte */
+#endif
+
+static int
+is_space(const char c)
+{
+    return (c == ' ') || ((c >= '\t') && (c <= '\r'));
+} /* is_space */
+
+
+/**
+ * \b digit_value
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Value of a digit in bases up to 36, 0-9 followed by a-z or A-Z.
+ *
+ * @param c Character to convert.
+ *
+ * @retval Value of the digit, 36 if it is not a digit.
+ */
+static unsigned int
+digit_value(const char c)
+{
+    const unsigned int lower = (unsigned int)(unsigned char)c | 0x20U;
+
+    if ((c >= '0') && (c <= '9')) {
+        return (unsigned int)(c - '0');
+    }
+    if ((lower >= 'a') && (lower <= 'z')) {
+        return lower - 'a' + 10U;
+    }
+    return 36U;
+} /* digit_value */
+
+
+#ifdef SPE_SWAR
+/**
+ * \b bytes_between
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Set the top bit of every byte of x between lo and hi. Every byte of x
+ * must be below 0x80, so no addition carries into the next byte.
+ *
+ * @param x Eight characters.
+ * @param lo Lowest character in range.
+ * @param hi Highest character in range.
+ *
+ * @retval Top bits of the bytes in range.
+ */
+static uint64_t
+bytes_between(const uint64_t x, const unsigned int lo, const unsigned int hi)
+{
+    return (x + ONES * (0x80U - lo)) & ~(x + ONES * (0x7fU - hi)) & HIGHS;
+} /* bytes_between */
+
+
+/**
+ * \b eight_decimal
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Parse eight decimal digits at once. The first character is in the lowest
+ * byte, so pairs of digits, then pairs of pairs and so on are combined
+ * with a multiplication each.
+ *
+ * @param s Eight characters, all readable.
+ * @param value Value of the digits, if they all are digits.
+ *
+ * @retval 1 if all eight are decimal digits.
+ * @retval 0 if not.
+ */
+static int
+eight_decimal(const char *s, uint64_t *value)
+{
+    uint64_t v;
+
+    memcpy(&v, s, sizeof(v));
+    if ((v & HIGHS) || (bytes_between(v, '0', '9') != HIGHS)) {
+        return 0;
+    }
+    v = ((v & 0x0f0f0f0f0f0f0f0fULL) * 2561U) >> 8;
+    v = ((v & 0x00ff00ff00ff00ffULL) * 6553601U) >> 16;
+    *value = ((v & 0x0000ffff0000ffffULL) * 42949672960001ULL) >> 32;
+
+    return 1;
+} /* eight_decimal */
+
+
+/**
+ * \b eight_hex
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Parse eight hex digits at once. Digits get their value from the low
+ * nibble, plus 9 for letters which have bit 6 set. The nibbles are then
+ * packed into pairs, pairs of pairs and so on with shifts.
+ *
+ * @param s Eight characters, all readable.
+ * @param value Value of the digits, if they all are hex digits.
+ *
+ * @retval 1 if all eight are hex digits.
+ * @retval 0 if not.
+ */
+static int
+eight_hex(const char *s, uint64_t *value)
+{
+    uint64_t v;
+
+    memcpy(&v, s, sizeof(v));
+    if ((v & HIGHS) ||
+        ((bytes_between(v, '0', '9') |
+          bytes_between(v | (ONES * 0x20U), 'a', 'f')) != HIGHS)) {
+        return 0;
+    }
+    v = (v & (ONES * 0x0fU)) + 9U * ((v >> 6) & ONES);
+    v = ((v << 4) | (v >> 8)) & 0x00ff00ff00ff00ffULL;
+    v = ((v << 8) | (v >> 16)) & 0x0000ffff0000ffffULL;
+    *value = ((v << 16) | (v >> 32)) & 0xffffffffULL;
+
+    return 1;
+} /* eight_hex */
+#endif /* SPE_SWAR */
+
+
+/**
+ * \b scan_digits
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Parse digits in base until end or the first character that is not a
+ * digit.
+ *
+ * @param s First character.
+ * @param end End of the field.
+ * @param base Base, 2 to 36.
+ * @param value Parsed value.
+ * @param overflow Set to 1 if the value does not fit.
+ *
+ * @retval Pointer after the last digit, s if there were none.
+ */
+static const char *
+scan_digits(const char *s, const char *end, const unsigned int base,
+            unsigned long *value, int *overflow)
+{
+    const unsigned long limit = ULONG_MAX / base;
+    unsigned long n = 0UL;
+
+#ifdef SPE_SWAR
+    uint64_t chunk;
+
+    if (base == 10U) {
+        while (((end - s) >= 8) && eight_decimal(s, &chunk)) {
+            if (n > (ULONG_MAX - (unsigned long)chunk) / 100000000UL) {
+                *overflow = 1;
+            } else {
+                n = n * 100000000UL + (unsigned long)chunk;
+            }
+            s += 8;
+        }
+    } else if (base == 16U) {
+        while (((end - s) >= 8) && eight_hex(s, &chunk)) {
+            /* Shifted in two steps, long may be 32 bits */
+            if (n > ((ULONG_MAX >> 16) >> 16)) {
+                *overflow = 1;
+            } else {
+                n = ((n << 16) << 16) | (unsigned long)chunk;
+            }
+            s += 8;
+        }
+    }
+#endif
+
+    for (; s < end; s++) {
+        const unsigned int digit = digit_value(*s);
+
+        if (digit >= base) {
+            break;
+        }
+        if ((n > limit) || ((n == limit) && (digit > ULONG_MAX % base))) {
+            *overflow = 1;
+        } else {
+            n = n * base + digit;
+        }
+    }
+    *value = n;
+
+    return s;
+} /* scan_digits */
+
+
+/**
+ * \b scan_integer
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Parse an integer like strtoul() does, with optional sign and, depending
+ * on base, 0x, 0b or 0 prefix.
+ *
+ * @param s First character, after any white space.
+ * @param end End of the field.
+ * @param base Base, 2 to 36, or 0 to take it from the prefix.
+ * @param value Parsed magnitude.
+ * @param neg Set to 1 if there was a minus sign.
+ * @param overflow Set to 1 if the magnitude does not fit.
+ *
+ * @retval Pointer after the integer, s if there was none.
+ */
+static const char *
+scan_integer(const char *s, const char *end, unsigned int base,
+             unsigned long *value, int *neg, int *overflow)
+{
+    const char *start = s;
+    const char *digits;
+
+    *value = 0UL;
+    *neg = 0;
+    *overflow = 0;
+    if ((base == 1U) || (base > 36U)) {
+        return start;
+    }
+
+    if ((s < end) && ((*s == '-') || (*s == '+'))) {
+        *neg = (*s == '-');
+        s++;
+    }
+    if (((end - s) >= 3) && (s[0] == '0')) {
+        const char x = (char)(s[1] | 0x20);
+
+        if ((x == 'x') && ((base == 0U) || (base == 16U)) &&
+            (digit_value(s[2]) < 16U)) {
+            base = 16U;
+            s += 2;
+        } else if ((x == 'b') && ((base == 0U) || (base == 2U)) &&
+                   (digit_value(s[2]) < 2U)) {
+            base = 2U;
+            s += 2;
+        }
+    }
+    if (base == 0U) {
+        base = ((s < end) && (*s == '0')) ? 8U : 10U;
+    }
+
+    digits = scan_digits(s, end, base, value, overflow);
+
+    return (digits == s) ? start : digits;
+} /* scan_integer */
+
+
+/**
+ * \b strto_common
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Common part of spe_strtol() and spe_strtoul(), skips white space and
+ * parses an integer.
+ *
+ * @param s String to parse.
+ * @param endp Set to the character after the integer, or s if there was
+ *          none. Can be NULL.
+ * @param base Base, 2 to 36, or 0 to take it from the prefix.
+ * @param value Parsed magnitude.
+ * @param neg Set to 1 if there was a minus sign.
+ * @param overflow Set to 1 if the magnitude does not fit.
+ */
+static void
+strto_common(const char *s, char **endp, const int base,
+             unsigned long *value, int *neg, int *overflow)
+{
+    const char *p = s;
+    const char *after;
+
+    while (is_space(*p)) {
+        p++;
+    }
+    after = scan_integer(p, p + strlen(p), (unsigned int)base, value, neg,
+                         overflow);
+    if (endp) {
+        /* Through uintptr_t, the libc prototype drops const */
+        *endp = (char *)(uintptr_t)((after == p) ? s : after);
+    }
+} /* strto_common */
+
+
+/**
+ * \b spe_strtol
+ *
+ * Refer to strtol() in libc. Bases up to 36 are supported. Base 0 also
+ * takes the 0b prefix for binary.
+ *
+ * @param s String to parse.
+ * @param endp Set to the character after the integer. Can be NULL.
+ * @param base Base, 2 to 36, or 0 to take it from the prefix.
+ *
+ * @retval The value, LONG_MIN or LONG_MAX with errno ERANGE if it does not
+ *          fit.
+ */
+long
+spe_strtol(const char *s, char **endp, int base)
+{
+    unsigned long value;
+    int neg, overflow;
+
+    strto_common(s, endp, base, &value, &neg, &overflow);
+    if (neg) {
+        if (overflow || (value > (unsigned long)LONG_MAX + 1UL)) {
+            errno = ERANGE;
+            return LONG_MIN;
+        }
+        return (value == 0UL) ? 0L : -(long)(value - 1UL) - 1L;
+    }
+    if (overflow || (value > (unsigned long)LONG_MAX)) {
+        errno = ERANGE;
+        return LONG_MAX;
+    }
+    return (long)value;
+} /* spe_strtol */
+
+
+/**
+ * \b spe_strtoul
+ *
+ * Refer to strtoul() in libc. A minus sign negates the value, as in libc.
+ *
+ * @param s String to parse.
+ * @param endp Set to the character after the integer. Can be NULL.
+ * @param base Base, 2 to 36, or 0 to take it from the prefix.
+ *
+ * @retval The value, ULONG_MAX with errno ERANGE if it does not fit.
+ */
+unsigned long
+spe_strtoul(const char *s, char **endp, int base)
+{
+    unsigned long value;
+    int neg, overflow;
+
+    strto_common(s, endp, base, &value, &neg, &overflow);
+    if (overflow) {
+        errno = ERANGE;
+        return ULONG_MAX;
+    }
+    return neg ? 0UL - value : value;
+} /* spe_strtoul */
+
+
+#ifdef USE_DOUBLE
+/* Powers of ten exact in a double */
+static const double exact_powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/* 5^k for k = 0..27, the odd part of 10^k, exact in 64 bits */
+static const uint64_t five_powers[] = {
+    1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL, 78125ULL,
+    390625ULL, 1953125ULL, 9765625ULL, 48828125ULL, 244140625ULL,
+    1220703125ULL, 6103515625ULL, 30517578125ULL, 152587890625ULL,
+    762939453125ULL, 3814697265625ULL, 19073486328125ULL, 95367431640625ULL,
+    476837158203125ULL, 2384185791015625ULL, 11920928955078125ULL,
+    59604644775390625ULL, 298023223876953125ULL, 1490116119384765625ULL,
+    7450580596923828125ULL,
+};
+
+/*
+ * 10^(28k) for k = -13..11 rounded down to 128 bits, hi:lo * 2^exp with
+ * the top bit of hi set. Together with five_powers they reach every power
+ * of ten that a 19 digit mantissa needs to span the doubles.
+ */
+static const struct {
+    uint64_t hi;
+    uint64_t lo;
+    int exp;
+} wide_powers[] = {
+    { 0xe1afa13afbd14d6dULL, 0x82189c09a3a1ec21ULL, -1337 }, /* 1e-364 */
+    { 0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL, -1244 }, /* 1e-336 */
+    { 0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL, -1151 }, /* 1e-308 */
+    { 0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL, -1058 }, /* 1e-280 */
+    { 0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL, -965 },  /* 1e-252 */
+    { 0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL, -872 },  /* 1e-224 */
+    { 0xef340a98172aace4ULL, 0x86fb897116c87c34ULL, -779 },  /* 1e-196 */
+    { 0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL, -686 },  /* 1e-168 */
+    { 0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL, -593 },  /* 1e-140 */
+    { 0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL, -500 },  /* 1e-112 */
+    { 0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL, -407 },  /* 1e-84 */
+    { 0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL, -314 },  /* 1e-56 */
+    { 0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL, -221 },  /* 1e-28 */
+    { 0x8000000000000000ULL, 0x0000000000000000ULL, -127 },  /* 1e0 */
+    { 0x813f3978f8940984ULL, 0x4000000000000000ULL, -34 },   /* 1e28 */
+    { 0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL, 59 },    /* 1e56 */
+    { 0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL, 152 },   /* 1e84 */
+    { 0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL, 245 },   /* 1e112 */
+    { 0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL, 338 },   /* 1e140 */
+    { 0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL, 431 },   /* 1e168 */
+    { 0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL, 524 },   /* 1e196 */
+    { 0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL, 617 },   /* 1e224 */
+    { 0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL, 710 },   /* 1e252 */
+    { 0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL, 803 },   /* 1e280 */
+    { 0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL, 896 },   /* 1e308 */
+};
+
+#define WIDE_STEP  28L    /* Powers of ten between wide_powers */
+#define WIDE_FIRST (-13L) /* k of the first of wide_powers */
+#define EXACT_DIVIDE 27L  /* Negative exponents done by exact division */
+
+#define MAX_SIGNIFICANT 19 /* Decimal digits that always fit in 64 bits */
+
+
+/**
+ * \b scan_mantissa
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_DOUBLE is defined.
+ *
+ * Parse decimal digits into the mantissa of a floating point number. Up to
+ * MAX_SIGNIFICANT digits are kept, the exponent is adjusted for the others.
+ *
+ * @param s First character.
+ * @param end End of the field.
+ * @param fraction Non-zero after the decimal point.
+ * @param mantissa Mantissa to add digits to.
+ * @param significant Number of digits in mantissa, leading zeros excluded.
+ * @param exp10 Decimal exponent to adjust.
+ *
+ * @retval Pointer after the last digit.
+ */
+static const char *
+scan_mantissa(const char *s, const char *end, const int fraction,
+              uint64_t *mantissa, int *significant, long *exp10)
+{
+#ifdef SPE_SWAR
+    uint64_t chunk;
+
+    /* Eight at a time, once leading zeros are passed and while they fit */
+    while ((*significant > 0) && (*significant <= MAX_SIGNIFICANT - 8) &&
+           ((end - s) >= 8) && eight_decimal(s, &chunk)) {
+        *mantissa = *mantissa * 100000000U + chunk;
+        *significant += 8;
+        if (fraction) {
+            *exp10 -= 8;
+        }
+        s += 8;
+    }
+#endif
+    for (; (s < end) && (*s >= '0') && (*s <= '9'); s++) {
+        if (*significant < MAX_SIGNIFICANT) {
+            *mantissa = *mantissa * 10U + (uint64_t)(*s - '0');
+            if (*mantissa) {
+                (*significant)++;
+            }
+            if (fraction) {
+                (*exp10)--;
+            }
+        } else if (!fraction) {
+            (*exp10)++;
+        }
+    }
+
+    return s;
+} /* scan_mantissa */
+
+
+/**
+ * \b mul_wide
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_DOUBLE is defined.
+ *
+ * Multiply two 64 bit numbers into 128 bits, with 32 bit halves so that
+ * it doesn't need a 128 bit type.
+ *
+ * @param a First factor.
+ * @param b Second factor.
+ * @param hi Upper 64 bits of the product.
+ * @param lo Lower 64 bits of the product.
+ */
+static void
+mul_wide(const uint64_t a, const uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+    const uint64_t a0 = a & 0xffffffffU;
+    const uint64_t a1 = a >> 32;
+    const uint64_t b0 = b & 0xffffffffU;
+    const uint64_t b1 = b >> 32;
+    const uint64_t p00 = a0 * b0;
+    const uint64_t p01 = a0 * b1;
+    const uint64_t p10 = a1 * b0;
+    const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffU) +
+        (p10 & 0xffffffffU);
+
+    *lo = (mid << 32) | (p00 & 0xffffffffU);
+    *hi = a1 * b1 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+} /* mul_wide */
+
+
+/**
+ * \b normalize_wide
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_DOUBLE is defined.
+ *
+ * Shift a non-zero 128 bit number left until its top bit is set.
+ *
+ * @param hi Upper 64 bits.
+ * @param lo Lower 64 bits.
+ *
+ * @retval Number of bits shifted.
+ */
+static long
+normalize_wide(uint64_t *hi, uint64_t *lo)
+{
+    long shift = 0L;
+
+    if (!*hi) {
+        *hi = *lo;
+        *lo = 0U;
+        shift = 64L;
+    }
+    for (; !(*hi & 0x8000000000000000ULL); shift++) {
+        *hi = (*hi << 1) | (*lo >> 63);
+        *lo <<= 1;
+    }
+
+    return shift;
+} /* normalize_wide */
+
+
+/**
+ * \b divide_wide
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_DOUBLE is defined.
+ *
+ * Divide a 128 bit number by a 32 bit one, 32 bits at a time.
+ *
+ * @param hi Upper 64 bits, replaced by those of the quotient.
+ * @param lo Lower 64 bits, replaced by those of the quotient.
+ * @param divisor Divisor, not 0.
+ *
+ * @retval Non-zero if there was a remainder.
+ */
+static int
+divide_wide(uint64_t *hi, uint64_t *lo, const uint64_t divisor)
+{
+    uint64_t part = *hi >> 32;
+    uint64_t q3, q2, q1;
+
+    q3 = part / divisor;
+    part = ((part % divisor) << 32) | (*hi & 0xffffffffU);
+    q2 = part / divisor;
+    part = ((part % divisor) << 32) | (*lo >> 32);
+    q1 = part / divisor;
+    part = ((part % divisor) << 32) | (*lo & 0xffffffffU);
+    *hi = (q3 << 32) | q2;
+    *lo = (q1 << 32) | (part / divisor);
+
+    return (part % divisor) != 0U;
+} /* divide_wide */
+
+
+/**
+ * \b scale_double
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_DOUBLE is defined.
+ *
+ * Convert mantissa * 10^exp10 to the nearest double, ties to even. The
+ * mantissa is widened to 128 bits and scaled there, so only the final
+ * rounding to 53 bits loses precision. Doubles are taken to be IEEE 754
+ * binary64 stored like a uint64_t, as on every target of this library.
+ *
+ * @param mantissa Decimal mantissa, not 0.
+ * @param exp10 Decimal exponent.
+ *
+ * @retval The value, infinity if it is too large.
+ */
+static double
+scale_double(const uint64_t mantissa, const long exp10)
+{
+    uint64_t hi, lo, m, rest, half, bits;
+    long exp2, lead;
+    long shift;
+    int inexact = 0;
+    double d;
+
+    if (exp10 > 308L) {
+        /* At least 1e309 */
+        bits = 0x7ff0000000000000ULL;
+    } else if (exp10 < -343L) {
+        /* Below half the smallest subnormal */
+        bits = 0U;
+    } else {
+        if ((exp10 < 0L) && (exp10 >= -EXACT_DIVIDE)) {
+            /* mantissa * 2^exp10 / 5^-exp10, exact with a remainder flag */
+            long left = -exp10;
+
+            hi = mantissa;
+            lo = 0U;
+            exp2 = exp10 - 64L - normalize_wide(&hi, &lo);
+            for (; left > 0L; left -= 13L) {
+                inexact |= divide_wide(&hi, &lo,
+                                       five_powers[(left > 13L) ? 13 : left]);
+            }
+            exp2 -= normalize_wide(&hi, &lo);
+        } else {
+            /* mantissa * 5^r * 2^r * 10^(28k), exact when k is 0 */
+            long k = (exp10 >= 0L) ? exp10 / WIDE_STEP :
+                -((-exp10 + WIDE_STEP - 1L) / WIDE_STEP);
+            long r = exp10 - k * WIDE_STEP;
+
+            mul_wide(mantissa, five_powers[r], &hi, &lo);
+            exp2 = r - normalize_wide(&hi, &lo);
+            if (k) {
+                uint64_t h, l, w1, w2, carry;
+                const long index = k - WIDE_FIRST;
+
+                /* Upper 192 bits of the 256 bit product, word by word */
+                mul_wide(lo, wide_powers[index].lo, &h, &l);
+                w1 = h;
+                mul_wide(lo, wide_powers[index].hi, &h, &l);
+                w1 += l;
+                w2 = h + (w1 < l);
+                mul_wide(hi, wide_powers[index].lo, &h, &l);
+                w1 += l;
+                carry = (w1 < l);
+                lo = w2 + h;
+                w2 = (lo < h);
+                lo += carry;
+                w2 += (lo < carry);
+                mul_wide(hi, wide_powers[index].hi, &h, &l);
+                lo += l;
+                hi = h + w2 + (lo < l);
+                if (!(hi & 0x8000000000000000ULL)) {
+                    hi = (hi << 1) | (lo >> 63);
+                    lo = (lo << 1) | (w1 >> 63);
+                    exp2--;
+                }
+                exp2 += 128L + wide_powers[index].exp;
+                /* The power was rounded down, so the value is above */
+                inexact = 1;
+            }
+        }
+
+        /* Keep 53 bits, fewer for subnormals */
+        lead = exp2 + 127L;
+        shift = (lead < -1022L) ? 11L + (-1022L - lead) : 11L;
+        inexact |= (lo != 0U);
+        if (lead > 1023L) {
+            bits = 0x7ff0000000000000ULL;
+        } else if (shift > 64L) {
+            bits = 0U;
+        } else {
+            if (shift == 64L) {
+                m = 0U;
+                rest = hi;
+            } else {
+                m = hi >> shift;
+                rest = hi & ((1ULL << shift) - 1U);
+            }
+            half = 1ULL << (shift - 1L);
+            if ((rest > half) || ((rest == half) && (inexact || (m & 1U)))) {
+                m++;
+            }
+            if (lead < -1022L) {
+                /* Rounding up to 2^52 makes it the smallest normal */
+                bits = m;
+            } else {
+                if (m >> 53) {
+                    m >>= 1;
+                    lead++;
+                }
+                bits = (lead > 1023L) ? 0x7ff0000000000000ULL :
+                    ((uint64_t)(lead + 1023L) << 52) |
+                    (m & 0x000fffffffffffffULL);
+            }
+        }
+    }
+    memcpy(&d, &bits, sizeof(d));
+
+    return d;
+} /* scale_double */
+
+
+/**
+ * \b scan_double
+ *
+ * This is an internal function not for use by application code.
+ * Only included if USE_DOUBLE is defined.
+ *
+ * Parse a floating point number like strtod() does, decimal notation
+ * only. See the top of the file for the accuracy.
+ *
+ * @param s First character, after any white space.
+ * @param end End of the field.
+ * @param value Parsed value.
+ *
+ * @retval Pointer after the number, s if there was none.
+ */
+static const char *
+scan_double(const char *s, const char *end, double *value)
+{
+    const char *start = s;
+    const char *digits;
+    uint64_t mantissa = 0U;
+    int significant = 0;
+    long exp10 = 0L;
+    int neg = 0;
+    double d;
+
+    if ((s < end) && ((*s == '-') || (*s == '+'))) {
+        neg = (*s == '-');
+        s++;
+    }
+    digits = s;
+    s = scan_mantissa(s, end, 0, &mantissa, &significant, &exp10);
+    if ((s < end) && (*s == '.')) {
+        s = scan_mantissa(s + 1, end, 1, &mantissa, &significant, &exp10);
+    }
+    if ((s == digits) || ((s == digits + 1) && (*digits == '.'))) {
+        return start;
+    }
+
+    /* The exponent is only taken if it has digits */
+    if (((end - s) >= 2) && ((s[0] | 0x20) == 'e')) {
+        const char *p = s + 1;
+        int exp_neg = 0;
+        long exp_value = 0L;
+
+        if ((*p == '-') || (*p == '+')) {
+            exp_neg = (*p == '-');
+            p++;
+        }
+        if ((p < end) && (*p >= '0') && (*p <= '9')) {
+            for (; (p < end) && (*p >= '0') && (*p <= '9'); p++) {
+                if (exp_value < 100000L) {
+                    exp_value = exp_value * 10L + (*p - '0');
+                }
+            }
+            exp10 += exp_neg ? -exp_value : exp_value;
+            s = p;
+        }
+    }
+
+    if (mantissa == 0U) {
+        d = 0.0;
+    } else if ((mantissa <= (1ULL << 53)) && (exp10 >= -22L) &&
+               (exp10 <= 22L)) {
+        /* Exact operands and a single rounding */
+        d = (double)mantissa;
+        d = (exp10 < 0L) ? d / exact_powers[-exp10] : d * exact_powers[exp10];
+    } else {
+        d = scale_double(mantissa, exp10);
+    }
+    *value = neg ? -d : d;
+
+    return s;
+} /* scan_double */
+
+
+/**
+ * \b spe_strtod
+ *
+ * Refer to strtod() in libc. Only included if USE_DOUBLE is defined.
+ * Decimal notation only, no hex floats, inf or nan. Rounded to nearest
+ * from the first 19 significant digits, see the top of the file.
+ *
+ * @param s String to parse.
+ * @param endp Set to the character after the number. Can be NULL.
+ *
+ * @retval The value, with errno ERANGE if it overflowed.
+ */
+double
+spe_strtod(const char *s, char **endp)
+{
+    const char *p = s;
+    const char *after;
+    double value = 0.0;
+
+    while (is_space(*p)) {
+        p++;
+    }
+    after = scan_double(p, p + strlen(p), &value);
+    if (endp) {
+        *endp = (char *)(uintptr_t)((after == p) ? s : after);
+    }
+    /* Only infinity minus itself is not 0 */
+    if ((value - value) != 0.0) {
+        errno = ERANGE;
+    }
+
+    return value;
+} /* spe_strtod */
+#endif /* USE_DOUBLE */
+
+
+/**
+ * \b scan_base
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Base of an integer conversion of spe_vsscanf().
+ *
+ * @param conversion Conversion character.
+ *
+ * @retval Base, 0 to take it from the prefix.
+ */
+static unsigned int
+scan_base(const char conversion)
+{
+    switch (conversion) {
+    case 'x':
+    case 'X':
+    case 'p':
+        return 16U;
+    case 'o':
+        return 8U;
+    case 'b':
+        return 2U;
+    case 'i':
+        return 0U;
+    default:
+        return 10U;
+    }
+} /* scan_base */
+
+
+/**
+ * \b scan_conversion
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Parse the input of one conversion of spe_vsscanf() and store the result.
+ *
+ * @param s Input, moved past the field.
+ * @param end End of input.
+ * @param fmt Format string.
+ * @param i Index of the % in fmt.
+ * @param ap A list of parameters in va_list format.
+ * @param assigned Incremented if something was stored.
+ *
+ * @retval Index of the conversion character in fmt.
+ * @retval -1 if the input did not match.
+ * @retval -2 if the input ended.
+ * @retval -3 on invalid format.
+ */
+static int
+scan_conversion(const char **s, const char *end, const char *fmt, int i,
+                va_list *ap, int *assigned)
+{
+    const char *p = *s;
+    const char *field_end = end;
+    int suppress = 0;
+    int long_modifier = 0;
+    unsigned long width = 0UL;
+    char conversion;
+
+    i++;
+    if (fmt[i] == '*') {
+        suppress = 1;
+        i++;
+    }
+    for (; (fmt[i] >= '0') && (fmt[i] <= '9'); i++) {
+        width = width * 10UL + (unsigned long)(fmt[i] - '0');
+    }
+    for (; fmt[i] == 'l'; i++) {
+        long_modifier++;
+    }
+    conversion = fmt[i];
+    if (conversion == 0) {
+        return -3;
+    }
+    /* A single l, and only where the pointer has a long variant */
+    if ((long_modifier > 1) ||
+        (long_modifier && ((conversion == 'c') || (conversion == 's') ||
+                           (conversion == 'p') || (conversion == '%')))) {
+        return -3;
+    }
+
+    /* All but %c skip white space */
+    if (conversion != 'c') {
+        while ((p < end) && is_space(*p)) {
+            p++;
+        }
+    }
+    if (p >= end) {
+        return -2;
+    }
+    if ((width > 0UL) && (width < (unsigned long)(end - p))) {
+        field_end = p + width;
+    }
+
+    switch (conversion) {
+    case '%':
+        if (*p != '%') {
+            return -1;
+        }
+        *s = p + 1;
+        return i;
+    case 'c':
+        if (width == 0UL) {
+            width = 1UL;
+        }
+        if ((unsigned long)(end - p) < width) {
+            return -2;
+        }
+        if (!suppress) {
+            memcpy(va_arg(*ap, char *), p, width);
+        }
+        p += width;
+        break;
+    case 's':
+        {
+            const char *start = p;
+
+            while ((p < field_end) && !is_space(*p)) {
+                p++;
+            }
+            if (!suppress) {
+                char *str = va_arg(*ap, char *);
+
+                memcpy(str, start, (size_t)(p - start));
+                str[p - start] = 0;
+            }
+        }
+        break;
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'b':
+    case 'p':
+        {
+            unsigned long value = 0UL;
+            int neg = 0, overflow;
+
+            if ((conversion == 'p') && ((end - p) >= 5) &&
+                !memcmp(p, "(nil)", 5)) {
+                p += 5;
+            } else {
+                const char *after = scan_integer(p, field_end,
+                                                 scan_base(conversion),
+                                                 &value, &neg, &overflow);
+                if (after == p) {
+                    return -1;
+                }
+                p = after;
+            }
+            if (neg) {
+                value = 0UL - value;
+            }
+            if (suppress) {
+                break;
+            }
+            if (conversion == 'p') {
+                *va_arg(*ap, void **) = (void *)(uintptr_t)value;
+            } else if (long_modifier &&
+                       ((conversion == 'd') || (conversion == 'i'))) {
+                *va_arg(*ap, long *) = (long)value;
+            } else if (long_modifier) {
+                *va_arg(*ap, unsigned long *) = value;
+            } else if ((conversion == 'd') || (conversion == 'i')) {
+                *va_arg(*ap, int *) = (int)(long)value;
+            } else {
+                *va_arg(*ap, unsigned int *) = (unsigned int)value;
+            }
+        }
+        break;
+#ifdef USE_DOUBLE
+    case 'f':
+    case 'e':
+    case 'g':
+    case 'E':
+    case 'G':
+        {
+            double value;
+            const char *after = scan_double(p, field_end, &value);
+
+            if (after == p) {
+                return -1;
+            }
+            p = after;
+            if (suppress) {
+                break;
+            }
+            if (long_modifier) {
+                *va_arg(*ap, double *) = value;
+            } else {
+                *va_arg(*ap, float *) = (float)value;
+            }
+        }
+        break;
+#endif /* USE_DOUBLE */
+    default:
+        return -3;
+    }
+
+    *s = p;
+    if (!suppress) {
+        (*assigned)++;
+    }
+
+    return i;
+} /* scan_conversion */
+
+
+/**
+ * \b spe_sscanf
+ *
+ * Refer to sscanf() in libc. See spe_scanf.h for the conversions.
+ *
+ * @param str String to parse.
+ * @param fmt Format string describing the input.
+ * @param ... Pointers to store the parsed values in.
+ *
+ * @retval >=0 Number of values stored.
+ * @retval -1 If the input ended before the first conversion, or on
+ *          invalid format.
+ */
+int
+spe_sscanf(const char *str, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_vsscanf(str, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_sscanf */
+
+
+/**
+ * \b spe_vsscanf
+ *
+ * Refer to vsscanf() in libc.
+ *
+ * @param str String to parse.
+ * @param fmt Format string describing the input.
+ * @param ap Pointers to store the parsed values in, in va_list format.
+ *
+ * @retval >=0 Number of values stored.
+ * @retval -1 If the input ended before the first conversion, or on
+ *          invalid format.
+ */
+int
+spe_vsscanf(const char *str, const char *fmt, va_list ap)
+{
+    const char *s = str;
+    const char *end = str + strlen(str);
+    int assigned = 0;
+    int nuf_conversions = 0;
+    int ret;
+    /* A copy, for the same reason as in spe_vfprintf() */
+    va_list ap_copy;
+    va_copy(ap_copy, ap);
+
+    for (int i = 0; fmt[i]; i++) {
+        if (is_space(fmt[i])) {
+            while ((s < end) && is_space(*s)) {
+                s++;
+            }
+        } else if (fmt[i] != '%') {
+            if ((s >= end) || (*s != fmt[i])) {
+                break;
+            }
+            s++;
+        } else {
+            ret = scan_conversion(&s, end, fmt, i, &ap_copy, &assigned);
+            if ((ret == -2) && (nuf_conversions == 0)) {
+                /* Input ended before the first conversion */
+                assigned = -1;
+            } else if (ret == -3) {
+                assigned = -1;
+            }
+            if (ret < 0) {
+                break;
+            }
+            nuf_conversions++;
+            i = ret;
+        }
+    }
+    va_end(ap_copy);
+
+    return assigned;
+} /* spe_vsscanf */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_SCANF_H
+#define SPE_SCANF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+
+/*
+ * The following conversion characters are supported by spe_sscanf():
+ * '%': Plain %
+ * 'c': Characters, width of them, default 1
+ * 's': String of non-white space characters
+ * 'd': Signed integer, takes int pointer
+ * 'u': Unsigned integer, takes unsigned int pointer
+ * 'x', 'X': Hex, optionally with 0x, takes unsigned int pointer
+ * 'o': Octal, takes unsigned int pointer
+ * 'b': Binary, optionally with 0b, takes unsigned int pointer
+ * 'p': Pointer, as printed by %p
+ * 'l': long modifier, used with d, i, u, x, X, o, b and f. ll and l with
+ *      other conversions are invalid format
+ * 'f', 'e', 'g': Floating point, takes float pointer, or double pointer
+ *      with l, if support is compiled in
+ * '*': Assignment suppression, the field is read but not stored
+ */
+
+long spe_strtol(const char *s, char **endp, int base);
+unsigned long spe_strtoul(const char *s, char **endp, int base);
+#ifdef USE_DOUBLE
+double spe_strtod(const char *s, char **endp);
+#endif
+
+int spe_sscanf(const char *str, const char *fmt, ...)
+    __attribute__((__format__(__scanf__, 2, 3)));
+int spe_vsscanf(const char *str, const char *fmt, va_list ap)
+    __attribute__((__format__(__scanf__, 2, 0)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_SCANF_H */
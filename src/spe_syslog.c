@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_syslog.c
+ *
+ * Log sink sending records to a syslog collector in batches, for Linux.
+ *
+ * Forwarding every line with its own send() costs a system call per line,
+ * which on a busy gateway is most of the cost of logging. Here a record is
+ * framed and formatted into a ring of records, and the ring is handed to
+ * the kernel with one sendmmsg() per SPE_SYSLOG_BATCH records, when it is
+ * full or when spe_syslog_flush() is called from the event loop or a
+ * timer. Each record is still a datagram of its own, as the collector
+ * expects.
+ *
+ * \code
+ * static struct spe_syslog_record pending[64];
+ * static struct spe_syslog sl = SPE_SYSLOG_SETUP(pending, LOG_DAEMON,
+ *                                                SPE_SYSLOG_RFC3164,
+ *                                                "gateway");
+ * struct sockaddr_un addr = { .sun_family = AF_UNIX,
+ *                             .sun_path = "/dev/log" };
+ *
+ * spe_syslog_connect(&sl, (struct sockaddr *)&addr, sizeof(addr));
+ * spe_syslog_printf(&sl, LOG_WARNING, "link %s down\n", ifname);
+ * ...
+ * spe_syslog_flush(&sl);
+ * \endcode
+ *
+ * Any datagram socket works, a UNIX socket such as /dev/log or UDP to a
+ * collector on the loopback. RFC 3164 framing is what syslog(3) sends
+ * locally, without a timestamp since the collector adds one. RFC 5424
+ * framing has a timestamp if now is set and spe_printf.c is compiled with
+ * USE_TIMESTAMP. A trailing newline is dropped and a record longer than
+ * SPE_SYSLOG_LINE is truncated.
+ *
+ * Sending never blocks. Records the collector can't take yet stay in the
+ * ring for the next flush, and when the ring is full a new record is
+ * refused. A sink must not be used concurrently.
+ */
+
+#define _GNU_SOURCE /* sendmmsg() */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "spe_printf.h"
+#include "spe_syslog.h"
+
+
+/**
+ * \b frame
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print the header of a record, up to the message.
+ *
+ * @param sl The sink.
+ * @param severity LOG_EMERG to LOG_DEBUG.
+ * @param text Room for SPE_SYSLOG_LINE characters.
+ *
+ * @retval Number of characters of the header.
+ */
+static size_t
+frame(struct spe_syslog *sl, const int severity, char *text)
+{
+    const int pri = (sl->facility & ~7) | (severity & 7);
+    const char *const app = sl->app ? sl->app : "-";
+    char stamp[32] = "-";
+    char procid[24] = "-";
+    size_t len;
+
+    if (sl->format == SPE_SYSLOG_RFC3164) {
+        if (sl->pid) {
+            return (size_t)spe_snprintf(text, SPE_SYSLOG_LINE, "<%d>%s[%lu]: ",
+                                        pri, app, sl->pid) - 1;
+        }
+        return (size_t)spe_snprintf(text, SPE_SYSLOG_LINE, "<%d>%s: ",
+                                    pri, app) - 1;
+    }
+
+#ifdef USE_TIMESTAMP
+    if (sl->now) {
+        const unsigned long long us = sl->now();
+
+        spe_snprintf_cache(stamp, sizeof(stamp), &sl->tcache, "%pTu", &us);
+    }
+#endif
+    if (sl->pid) {
+        spe_snprintf(procid, sizeof(procid), "%lu", sl->pid);
+    }
+    /* Two calls keep the arguments in registers on most ABIs */
+    len = (size_t)spe_snprintf(text, SPE_SYSLOG_LINE, "<%d>1 %s %s ", pri,
+                               stamp, sl->hostname ? sl->hostname : "-") - 1;
+    return len + (size_t)spe_snprintf(&text[len], SPE_SYSLOG_LINE - len,
+                                      "%s %s - - ", app, procid) - 1;
+} /* frame */
+
+
+/**
+ * \b spe_syslog_connect
+ *
+ * Open a datagram socket to a collector, closing the one in use. Sets the
+ * PROCID to the process id unless one is set already.
+ *
+ * @param sl The sink.
+ * @param addr Address of the collector, AF_UNIX, AF_INET or AF_INET6.
+ * @param addr_len Size of addr.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure, with errno set, the socket in use is kept.
+ */
+int
+spe_syslog_connect(struct spe_syslog *sl, const struct sockaddr *addr,
+                   socklen_t addr_len)
+{
+    const int sock = socket(addr->sa_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (sock < 0) {
+        return -1;
+    }
+    if (connect(sock, addr, addr_len) < 0) {
+        const int error = errno;
+
+        close(sock);
+        errno = error;
+        return -1;
+    }
+    if (sl->sock >= 0) {
+        close(sl->sock);
+    }
+    sl->sock = sock;
+    if (!sl->pid) {
+        sl->pid = (unsigned long)getpid();
+    }
+
+    return 0;
+} /* spe_syslog_connect */
+
+
+/**
+ * \b spe_syslog_printf
+ *
+ * Queue a record, sending the ring when it gets full.
+ *
+ * @param sl The sink.
+ * @param severity LOG_EMERG to LOG_DEBUG from <syslog.h>.
+ * @param fmt Format string for formatting the message.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure, or if the ring is full and can't be sent.
+ */
+int
+spe_syslog_printf(struct spe_syslog *sl, int severity, const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_syslog_vprintf(sl, severity, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_syslog_printf */
+
+
+/**
+ * \b spe_syslog_vprintf
+ *
+ * Variadic version of spe_syslog_printf().
+ *
+ * @param sl The sink.
+ * @param severity LOG_EMERG to LOG_DEBUG from <syslog.h>.
+ * @param fmt Format string for formatting the message.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure, or if the ring is full and can't be sent.
+ */
+int
+spe_syslog_vprintf(struct spe_syslog *sl, int severity, const char *fmt,
+                   va_list ap)
+{
+    struct spe_syslog_record *rec;
+    size_t len;
+    int body;
+
+    if (sl->count == sl->size) {
+        spe_syslog_flush(sl);
+        if (sl->count == sl->size) {
+            return -1;
+        }
+    }
+
+    rec = &sl->ring[(sl->head + sl->count) % sl->size];
+    len = frame(sl, severity, rec->text);
+    /* Includes the terminating \0 */
+#ifdef USE_TIMESTAMP
+    body = spe_vsnprintf_cache(&rec->text[len], sizeof(rec->text) - len,
+                               &sl->tcache, fmt, ap);
+#else
+    body = spe_vsnprintf(&rec->text[len], sizeof(rec->text) - len, fmt, ap);
+#endif
+    if (body < 0) {
+        return -1;
+    }
+    len += (size_t)body - 1;
+    if (len && (rec->text[len - 1] == '\n')) {
+        len--;
+    }
+    rec->len = len;
+
+    if (++sl->count == sl->size) {
+        spe_syslog_flush(sl);
+    }
+
+    return 0;
+} /* spe_syslog_vprintf */
+
+
+/**
+ * \b spe_syslog_flush
+ *
+ * Send the records in the ring, SPE_SYSLOG_BATCH per system call, until
+ * all are sent or the socket would block.
+ *
+ * @param sl The sink.
+ *
+ * @retval >=0 Number of records sent.
+ * @retval -1 On failure, with errno set. Records not sent are kept.
+ */
+int
+spe_syslog_flush(struct spe_syslog *sl)
+{
+    struct mmsghdr msgs[SPE_SYSLOG_BATCH];
+    struct iovec iov[SPE_SYSLOG_BATCH];
+    int total = 0;
+
+    while (sl->count) {
+        const size_t batch = (sl->count < SPE_SYSLOG_BATCH) ?
+            sl->count : SPE_SYSLOG_BATCH;
+        size_t k;
+        int sent;
+
+        memset(msgs, 0, batch * sizeof(msgs[0]));
+        for (k = 0; k < batch; k++) {
+            struct spe_syslog_record *rec =
+                &sl->ring[(sl->head + k) % sl->size];
+
+            iov[k].iov_base = rec->text;
+            iov[k].iov_len = rec->len;
+            msgs[k].msg_hdr.msg_iov = &iov[k];
+            msgs[k].msg_hdr.msg_iovlen = 1;
+        }
+
+        sent = sendmmsg(sl->sock, msgs, (unsigned int)batch, MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) ||
+                (errno == ENOBUFS)) {
+                break;
+            }
+            return -1;
+        }
+        sl->head = (sl->head + (size_t)sent) % sl->size;
+        sl->count -= (size_t)sent;
+        total += sent;
+        if ((size_t)sent < batch) {
+            break; /* The rest would block */
+        }
+    }
+
+    return total;
+} /* spe_syslog_flush */
+
+
+/**
+ * \b spe_syslog_close
+ *
+ * Send what can be sent and close the socket. Records not sent are kept.
+ *
+ * @param sl The sink.
+ */
+void
+spe_syslog_close(struct spe_syslog *sl)
+{
+    if (sl->sock >= 0) {
+        spe_syslog_flush(sl);
+        close(sl->sock);
+        sl->sock = -1;
+    }
+} /* spe_syslog_close */
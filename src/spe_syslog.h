@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_SYSLOG_H
+#define SPE_SYSLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stddef.h> /* size_t */
+#include <sys/socket.h>
+
+#include "spe_printf.h"
+
+#ifndef SPE_SYSLOG_LINE
+#define SPE_SYSLOG_LINE 256 /*!< Most characters of a record, header included */
+#endif
+
+#ifndef SPE_SYSLOG_BATCH
+#define SPE_SYSLOG_BATCH 16 /*!< Most records handed to one sendmmsg() */
+#endif
+
+/**
+ * Framing of a record.
+ */
+enum spe_syslog_format {
+    SPE_SYSLOG_RFC3164, /*!< `<PRI>APP[PID]: MSG`, as syslog(3) locally */
+    SPE_SYSLOG_RFC5424, /*!< `<PRI>1 TIMESTAMP HOST APP PID - - MSG` */
+};
+
+/**
+ * A framed record waiting to be sent. Don't modify directly.
+ */
+struct spe_syslog_record {
+    size_t len;                 /*!< Characters in text */
+    char text[SPE_SYSLOG_LINE]; /*!< Header and message */
+};
+
+/**
+ * Datagram log sink. Use macro SPE_SYSLOG_SETUP for initialisation, then
+ * spe_syslog_connect() or set sock to a connected datagram socket.\n
+ * Don't modify directly.
+ */
+struct spe_syslog {
+    int sock;                           /*!< Connected socket, -1 if none */
+    struct spe_syslog_record *ring;     /*!< Records not yet sent */
+    size_t size;                        /*!< Records in ring */
+    size_t head;                        /*!< Oldest record in ring */
+    size_t count;                       /*!< Records waiting in ring */
+    enum spe_syslog_format format;      /*!< Framing of the records */
+    int facility;                       /*!< LOG_USER, LOG_DAEMON... */
+    const char *app;                    /*!< APP-NAME or TAG, may be NULL */
+    const char *hostname;               /*!< HOSTNAME for RFC 5424, may be
+                                             NULL */
+    unsigned long pid;                  /*!< PROCID, 0 for none */
+    unsigned long long (*now)(void);    /*!< Microseconds since epoch for
+                                             RFC 5424, may be NULL */
+#ifdef USE_TIMESTAMP
+    struct spe_time_cache tcache;       /*!< %pT cache of the records */
+#endif
+};
+
+/**
+ * Set up a sink from an array of struct spe_syslog_record, a facility
+ * from <syslog.h>, a format and the name of the application.
+ */
+#define SPE_SYSLOG_SETUP(records, fac, fmt, app_name)               \
+    {                                                               \
+        .sock = -1,                                                 \
+        .ring = records,                                            \
+        .size = sizeof(records) / sizeof((records)[0]),             \
+        .head = 0,                                                  \
+        .count = 0,                                                 \
+        .format = fmt,                                              \
+        .facility = fac,                                            \
+        .app = app_name,                                            \
+        .hostname = NULL,                                           \
+        .pid = 0,                                                   \
+        .now = NULL,                                                \
+        SPE_TIME_CACHE_SETUP                                        \
+    }
+
+int spe_syslog_connect(struct spe_syslog *sl, const struct sockaddr *addr,
+                       socklen_t addr_len);
+int spe_syslog_printf(struct spe_syslog *sl, int severity,
+                      const char *fmt, ...)
+    __attribute__((__format__(__printf__, 3, 4)));
+int spe_syslog_vprintf(struct spe_syslog *sl, int severity,
+                       const char *fmt, va_list ap)
+    __attribute__((__format__(__printf__, 3, 0)));
+int spe_syslog_flush(struct spe_syslog *sl);
+void spe_syslog_close(struct spe_syslog *sl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_SYSLOG_H */
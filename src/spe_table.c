@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_table.c
+ *
+ * Tables with columns as wide as their contents.
+ *
+ * Hand picked widths such as %8u break as soon as a value grows. Here the
+ * cells are struct spe_arg, row after row, and spe_table_measure() finds
+ * the width of every column by counting the characters of each cell with
+ * spe_arg_length(), the digit counting of the conversions, without
+ * printing anything. The header and rows are then printed straight to the
+ * file descriptor, padding in runs and each cell with its conversion, so
+ * no row is ever kept in a buffer.
+ *
+ * \code
+ * static struct spe_table_column columns[] = {
+ *     { .title = "task", .conversion = 's', .left = 1 },
+ *     { .title = "stack", .conversion = 'u' },
+ *     { .title = "flags", .conversion = 'x' },
+ * };
+ * static struct spe_table table = SPE_TABLE_SETUP(columns, "  ");
+ * const struct spe_arg cells[] = {
+ *     SPE_ARG_STRING("idle"), SPE_ARG_UINT(128), SPE_ARG_UINT(0x3),
+ *     SPE_ARG_STRING("radio"), SPE_ARG_UINT(1024), SPE_ARG_UINT(0x11),
+ * };
+ *
+ * spe_table_measure(&table, cells, 2);
+ * spe_table_header(uart, &table);
+ * spe_table_rows(uart, &table, cells, 2);
+ * \endcode
+ *
+ * Measuring can be done in several batches, the widths only grow, so rows
+ * generated one at a time can be measured in a first pass and printed in
+ * a second. A cell wider than its column, not measured, pushes the rest of
+ * its row to the right. Long arguments print with %l.
+ *
+ * Requires spe_printf.c compiled with USE_ARG_PACK.
+ */
+
+#include <string.h>
+
+#include "spe_printf.h"
+#include "spe_table.h"
+
+
+/**
+ * \b pad
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print a character n times, SPE_TABLE_PAD at a time.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param c The character.
+ * @param n Number of times, nothing if not above 0.
+ */
+static void
+pad(SPE_FILE *fd, const char c, int n)
+{
+    char run[SPE_TABLE_PAD + 1];
+
+    memset(run, c, SPE_TABLE_PAD);
+    run[SPE_TABLE_PAD] = '\0';
+    for (; n >= SPE_TABLE_PAD; n -= SPE_TABLE_PAD) {
+        spe_fputs(run, fd);
+    }
+    if (n > 0) {
+        run[n] = '\0';
+        spe_fputs(run, fd);
+    }
+} /* pad */
+
+
+/**
+ * \b print_cell
+ *
+ * This is an internal function not for use by application code.
+ *
+ * Print text of len characters aligned within its column, without the
+ * padding right of the last column.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param table The table.
+ * @param column Index of the column.
+ * @param cell The cell, or NULL to print text.
+ * @param text Title to print, if cell is NULL.
+ * @param len Characters that cell or text prints.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+static int
+print_cell(SPE_FILE *fd, const struct spe_table *table, const size_t column,
+           const struct spe_arg *cell, const char *text, const int len)
+{
+    const struct spe_table_column *col = &table->columns[column];
+    const int space = col->width - len;
+
+    if (column > 0) {
+        spe_fputs(table->separator, fd);
+    }
+    if (!col->left) {
+        pad(fd, ' ', space);
+    }
+    if (!cell) {
+        spe_fputs(text, fd);
+    } else if ((cell->type != SPE_ARG_TYPE_STRING) || cell->v.s) {
+        const int is_long = (cell->type == SPE_ARG_TYPE_LONG) ||
+            (cell->type == SPE_ARG_TYPE_ULONG);
+        const char fmt[4] = {
+            '%', is_long ? 'l' : col->conversion,
+            is_long ? col->conversion : '\0', '\0'
+        };
+
+        if (spe_fprintf_args(fd, fmt, cell, 1) < 0) {
+            return -1;
+        }
+    }
+    if (col->left && (column + 1 < table->nuf_columns)) {
+        pad(fd, ' ', space);
+    }
+    return 0;
+} /* print_cell */
+
+
+/**
+ * \b spe_table_measure
+ *
+ * Widen the columns to fit their titles and the cells of nuf_rows rows.
+ *
+ * @param table The table.
+ * @param cells The cells, a row of table->nuf_columns after another.
+ * @param nuf_rows Number of rows.
+ *
+ * @retval 0 On success.
+ * @retval -1 If a cell can't be printed with the conversion of its column.
+ */
+int
+spe_table_measure(struct spe_table *table, const struct spe_arg *cells,
+                  size_t nuf_rows)
+{
+    size_t row, column;
+
+    for (column = 0; column < table->nuf_columns; column++) {
+        struct spe_table_column *col = &table->columns[column];
+        const int len = (int)strlen(col->title);
+
+        if (col->width < len) {
+            col->width = len;
+        }
+        for (row = 0; row < nuf_rows; row++) {
+            const int cell_len = spe_arg_length(
+                &cells[row * table->nuf_columns + column], col->conversion);
+
+            if (cell_len < 0) {
+                return -1;
+            }
+            if (col->width < cell_len) {
+                col->width = cell_len;
+            }
+        }
+    }
+    return 0;
+} /* spe_table_measure */
+
+
+/**
+ * \b spe_table_header
+ *
+ * Print the titles and a line under each.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param table The table.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int
+spe_table_header(SPE_FILE *fd, const struct spe_table *table)
+{
+    size_t column;
+
+    for (column = 0; column < table->nuf_columns; column++) {
+        const char *title = table->columns[column].title;
+
+        print_cell(fd, table, column, NULL, title, (int)strlen(title));
+    }
+    spe_fputc('\n', fd);
+    for (column = 0; column < table->nuf_columns; column++) {
+        if (column > 0) {
+            spe_fputs(table->separator, fd);
+        }
+        pad(fd, '-', table->columns[column].width);
+    }
+    spe_fputc('\n', fd);
+
+    return 0;
+} /* spe_table_header */
+
+
+/**
+ * \b spe_table_rows
+ *
+ * Print nuf_rows rows, each cell aligned in its column.
+ *
+ * @param fd Pointer to filedescriptor to output result to.
+ * @param table The table.
+ * @param cells The cells, a row of table->nuf_columns after another.
+ * @param nuf_rows Number of rows.
+ *
+ * @retval 0 On success.
+ * @retval -1 If a cell can't be printed with the conversion of its column.
+ */
+int
+spe_table_rows(SPE_FILE *fd, const struct spe_table *table,
+               const struct spe_arg *cells, size_t nuf_rows)
+{
+    size_t row, column;
+
+    for (row = 0; row < nuf_rows; row++) {
+        for (column = 0; column < table->nuf_columns; column++) {
+            const struct spe_arg *cell = cells++;
+            const int len = spe_arg_length(cell,
+                                           table->columns[column].conversion);
+
+            if ((len < 0) ||
+                (print_cell(fd, table, column, cell, NULL, len) < 0)) {
+                return -1;
+            }
+        }
+        spe_fputc('\n', fd);
+    }
+    return 0;
+} /* spe_table_rows */
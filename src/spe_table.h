@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_TABLE_H
+#define SPE_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h> /* size_t */
+
+#include "spe_printf.h"
+
+/** Characters of padding printed in one go */
+#ifndef SPE_TABLE_PAD
+#define SPE_TABLE_PAD 16
+#endif
+
+/**
+ * Column of a table.
+ */
+struct spe_table_column {
+    const char *title;  /*!< Heading */
+    char conversion;    /*!< d, u, x, X, o, b, c or s */
+    char left;          /*!< Non-zero to align left, otherwise right */
+    int width;          /*!< Set by spe_table_measure(), 0 to start with */
+};
+
+/**
+ * Table. Use macro SPE_TABLE_SETUP for initialisation.
+ */
+struct spe_table {
+    struct spe_table_column *columns;   /*!< The columns */
+    size_t nuf_columns;                 /*!< Entries in columns */
+    const char *separator;              /*!< Between columns */
+};
+
+/**
+ * Set up a table from an array of struct spe_table_column and the text
+ * between columns.
+ */
+#define SPE_TABLE_SETUP(columns_array, sep)                            \
+    {                                                                  \
+        .columns = columns_array,                                      \
+        .nuf_columns = sizeof(columns_array) / sizeof((columns_array)[0]), \
+        .separator = sep,                                              \
+    }
+
+int spe_table_measure(struct spe_table *table, const struct spe_arg *cells,
+                      size_t nuf_rows);
+int spe_table_header(SPE_FILE *fd, const struct spe_table *table);
+int spe_table_rows(SPE_FILE *fd, const struct spe_table *table,
+                   const struct spe_arg *cells, size_t nuf_rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_TABLE_H */
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file spe_tee.c
+ *
+ * Fan-out of formatted text to several file descriptors.
+ *
+ * The same line often goes to more than one output, for instance a UART,
+ * a crash log in RAM and a host connection. Calling spe_fprintf() once per
+ * output parses the format string and converts every argument again for
+ * each of them. A tee formats once into its staging buffer and then
+ * delivers the line with one spe_fwrite() to each sink whose mask has a
+ * bit in common with the severity of the line, so a string sink takes it
+ * in one copy. The length comes from the formatting, so a \0 printed by
+ * %c is delivered like any other character.
+ *
+ * \code
+ * static char tee_buf[128];
+ * static const struct spe_tee_sink tee_sinks[] = {
+ *     { &uart, 0xffU },
+ *     { &crash_log, 0xf0U },
+ * };
+ * static struct spe_tee tee = SPE_TEE_SETUP(tee_buf, tee_sinks);
+ *
+ * spe_tee_printf(&tee, 0x10U, "Temperature %d\n", temp);
+ * \endcode
+ *
+ * Lines longer than the staging buffer are truncated, with room for one
+ * character less than its size. The staging buffer is shared, so a tee
+ * must not be used concurrently.
+ */
+
+#include <stdarg.h>
+
+#include "spe_tee.h"
+
+
+/**
+ * \b spe_tee_printf
+ *
+ * Format once and deliver to every sink of the tee that wants severity.
+ *
+ * @param tee Tee to print to.
+ * @param severity Severity bit(s) of the text, matched against the mask of
+ *          every sink.
+ * @param fmt Format string for formatting the text.
+ * @param ... A list of parameters to be displayed.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int
+spe_tee_printf(struct spe_tee *tee, unsigned int severity,
+               const char *fmt, ...)
+{
+    va_list ap;
+    int returned;
+
+    va_start(ap, fmt);
+    returned = spe_tee_vprintf(tee, severity, fmt, ap);
+    va_end(ap);
+
+    return returned;
+} /* spe_tee_printf */
+
+
+/**
+ * \b spe_tee_vprintf
+ *
+ * Variadic version of spe_tee_printf(). No formatting is done if no sink
+ * wants severity.
+ *
+ * @param tee Tee to print to.
+ * @param severity Severity bit(s) of the text.
+ * @param fmt Format string for formatting the text.
+ * @param ap A list of parameters in va_list format.
+ *
+ * @retval 0 On success.
+ * @retval -1 On failure.
+ */
+int
+spe_tee_vprintf(struct spe_tee *tee, unsigned int severity,
+                const char *fmt, va_list ap)
+{
+    unsigned int wanted = 0U;
+    size_t i;
+    int len;
+
+    for (i = 0; i < tee->nuf_sinks; i++) {
+        wanted |= tee->sinks[i].mask;
+    }
+    if (!(wanted & severity)) {
+        return 0;
+    }
+
+    /* Includes the terminating \0, which is not delivered */
+#ifdef USE_TIMESTAMP
+    len = spe_vsnprintf_cache(tee->buf, tee->size, &tee->tcache, fmt, ap);
+#else
+    len = spe_vsnprintf(tee->buf, tee->size, fmt, ap);
+#endif
+    if (len < 0) {
+        return -1;
+    }
+
+    for (i = 0; i < tee->nuf_sinks; i++) {
+        if (!(tee->sinks[i].mask & severity)) {
+            continue;
+        }
+        spe_fwrite(tee->buf, 1, (size_t)len - 1U, tee->sinks[i].fd);
+    }
+
+    return 0;
+} /* spe_tee_vprintf */
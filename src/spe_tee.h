@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPE_TEE_H
+#define SPE_TEE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stddef.h> /* size_t */
+
+#include "spe_printf.h"
+
+/**
+ * One output of a tee, with the severities it wants.
+ */
+struct spe_tee_sink {
+    SPE_FILE *fd;      /*!< File descriptor to deliver to */
+    unsigned int mask; /*!< Severities delivered, see spe_tee_printf() */
+};
+
+/**
+ * Tee declaration. Use macro SPE_TEE_SETUP for initialisation.\n
+ * Don't modify directly.
+ */
+struct spe_tee {
+    char *buf;                        /*!< Staging buffer */
+    size_t size;                      /*!< Size of the staging buffer */
+    const struct spe_tee_sink *sinks; /*!< Outputs */
+    size_t nuf_sinks;                 /*!< Number of outputs */
+#ifdef USE_TIMESTAMP
+    struct spe_time_cache tcache;     /*!< %pT cache of the staging buffer */
+#endif
+};
+
+/**
+ * Set up a tee from a staging buffer array and an array of sinks.
+ */
+#define SPE_TEE_SETUP(b, s)                             \
+    {                                                   \
+        .buf = b,                                       \
+        .size = sizeof(b),                              \
+        .sinks = s,                                     \
+        .nuf_sinks = sizeof(s) / sizeof((s)[0]),        \
+        SPE_TIME_CACHE_SETUP                            \
+    }
+
+int spe_tee_printf(struct spe_tee *tee, unsigned int severity,
+                   const char *fmt, ...)
+    __attribute__((__format__(__printf__, 3, 4)));
+int spe_tee_vprintf(struct spe_tee *tee, unsigned int severity,
+                    const char *fmt, va_list ap)
+    __attribute__((__format__(__printf__, 3, 0)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPE_TEE_H */
@@ -22,3 +22,14 @@
  */
 
 IMPORT_TEST_GROUP(spe_printf);
+IMPORT_TEST_GROUP(spe_tee);
+IMPORT_TEST_GROUP(spe_log);
+IMPORT_TEST_GROUP(spe_scanf);
+IMPORT_TEST_GROUP(spe_lcd);
+IMPORT_TEST_GROUP(spe_lz);
+IMPORT_TEST_GROUP(spe_async);
+IMPORT_TEST_GROUP(spe_column);
+IMPORT_TEST_GROUP(spe_crash);
+IMPORT_TEST_GROUP(spe_repeat);
+IMPORT_TEST_GROUP(spe_table);
+IMPORT_TEST_GROUP(spe_syslog);
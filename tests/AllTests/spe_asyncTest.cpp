@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_async.h"
+}
+
+/* A FIFO with room for fifo_room more characters */
+static char fifo[64];
+static size_t fifo_len;
+static size_t fifo_room;
+
+static int
+fifo_putc(char c)
+{
+    if (!fifo_room) {
+        return 1;
+    }
+    fifo_room--;
+    fifo[fifo_len++] = c;
+    return 0;
+}
+
+static char async_buf[16];
+static struct spe_async async = SPE_ASYNC_SETUP(async_buf, fifo_putc);
+
+TEST_GROUP(spe_async)
+{
+    void setup() {
+        memset(fifo, 0, sizeof(fifo));
+        fifo_len = 0;
+        fifo_room = sizeof(fifo);
+        while (spe_async_resume(&async)) {
+        }
+        fifo_len = 0;
+        fifo_room = sizeof(fifo);
+    }
+};
+
+TEST(spe_async, AllTaken)
+{
+    LONGS_EQUAL(0, spe_async_printf(&async, "T=%d.", -12));
+    STRCMP_EQUAL("T=-12.", fifo);
+}
+
+TEST(spe_async, WouldBlockThenResume)
+{
+    fifo_room = 2;
+    LONGS_EQUAL(4, spe_async_printf(&async, "T=%d.", -12));
+    STRCMP_EQUAL("T=", fifo);
+
+    LONGS_EQUAL(4, spe_async_resume(&async));
+    fifo_room = 3;
+    LONGS_EQUAL(1, spe_async_resume(&async));
+    STRCMP_EQUAL("T=-12", fifo);
+    fifo_room = 10;
+    LONGS_EQUAL(0, spe_async_resume(&async));
+    STRCMP_EQUAL("T=-12.", fifo);
+}
+
+TEST(spe_async, QueuedBehindPending)
+{
+    fifo_room = 3;
+    LONGS_EQUAL(3, spe_async_printf(&async, "abc%s", "def"));
+    LONGS_EQUAL(8, spe_async_printf(&async, "%d", 12345));
+    fifo_room = 10;
+    LONGS_EQUAL(0, spe_async_resume(&async));
+    STRCMP_EQUAL("abcdef12345", fifo);
+}
+
+TEST(spe_async, RefusedWhenNoRoom)
+{
+    fifo_room = 0;
+    LONGS_EQUAL(10, spe_async_printf(&async, "0123456789"));
+    LONGS_EQUAL(-1, spe_async_printf(&async, "abcdefghij"));
+    LONGS_EQUAL(15, spe_async_printf(&async, "abcde"));
+    LONGS_EQUAL(16, spe_async_printf(&async, "x"));
+    LONGS_EQUAL(-1, spe_async_printf(&async, "y"));
+    LONGS_EQUAL(-1, spe_async_printf(&async, "%c", 'y'));
+    fifo_room = 20;
+    LONGS_EQUAL(0, spe_async_resume(&async));
+    STRCMP_EQUAL("0123456789abcdex", fifo);
+}
+
+/* A text that doesn't fit is kept out whole, and fits once delivered */
+TEST(spe_async, PartialFitRefused)
+{
+    fifo_room = 4;
+    LONGS_EQUAL(6, spe_async_printf(&async, "%s", "0123456789"));
+    LONGS_EQUAL(-1, spe_async_printf(&async, "%s", "abcdefghijk"));
+    fifo_room = 6;
+    LONGS_EQUAL(11, spe_async_printf(&async, "%s", "abcdefghijk"));
+    fifo_room = 20;
+    LONGS_EQUAL(0, spe_async_resume(&async));
+    STRCMP_EQUAL("0123456789abcdefghijk", fifo);
+}
+
+/* Text that exactly fills the free room is taken, one more is refused */
+static char small_buf[8];
+static struct spe_async small = SPE_ASYNC_SETUP(small_buf, fifo_putc);
+
+static void
+check_small(const char *expected)
+{
+    fifo_room = 20;
+    fifo_len = 0;
+    LONGS_EQUAL(0, spe_async_resume(&small));
+    STRCMP_EQUAL(expected, fifo);
+}
+
+TEST(spe_async, ExactFit)
+{
+    fifo_room = 0;
+    LONGS_EQUAL(8, spe_async_printf(&small, "12345678"));
+    LONGS_EQUAL(8, spe_async_printf(&small, "%s", ""));
+    LONGS_EQUAL(-1, spe_async_printf(&small, "x"));
+    check_small("12345678");
+
+    fifo_room = 0;
+    LONGS_EQUAL(-1, spe_async_printf(&small, "%s", "123456789"));
+    LONGS_EQUAL(8, spe_async_printf(&small, "%s", "12345678"));
+    check_small("12345678");
+
+    fifo_room = 0;
+    LONGS_EQUAL(-1, spe_async_printf(&small, "%d", 123456789));
+    LONGS_EQUAL(8, spe_async_printf(&small, "%d", 12345678));
+    check_small("12345678");
+
+    fifo_room = 0;
+    LONGS_EQUAL(-1, spe_async_printf(&small, "1234%5d", 5678));
+    LONGS_EQUAL(8, spe_async_printf(&small, "1234%4d", 5678));
+    check_small("12345678");
+
+    fifo_room = 0;
+    LONGS_EQUAL(7, spe_async_printf(&small, "1234567"));
+    LONGS_EQUAL(-1, spe_async_printf(&small, "%c%c", 'x', 'y'));
+    LONGS_EQUAL(8, spe_async_printf(&small, "%c", 'x'));
+    check_small("1234567x");
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_column.h"
+}
+
+static char column[1200];
+static size_t column_len;
+
+static void
+column_putc(char c)
+{
+    if (column_len < sizeof(column) - 1) {
+        column[column_len++] = c;
+    }
+}
+
+static SPE_FILE column_fd = SPE_PRINTF_SETUP(column_putc);
+
+TEST_GROUP(spe_column)
+{
+    void setup() {
+        memset(column, 0, sizeof(column));
+        column_len = 0;
+    }
+};
+
+/* Every number of digits, and both sides of every power of ten */
+TEST(spe_column, UnsignedLikeSnprintf)
+{
+    uint32_t values[21];
+    char expected[256];
+    uint32_t power = 1U;
+    size_t len = 0;
+    int i;
+
+    values[0] = 0U;
+    for (i = 0; i < 10; i++) {
+        values[1 + 2 * i] = power;
+        values[2 + 2 * i] = (i < 9) ? power * 10U - 1U : 4294967295U;
+        power *= 10U;
+    }
+    for (i = 0; i < 21; i++) {
+        len += (size_t)snprintf(&expected[len], sizeof(expected) - len,
+                                (i < 20) ? "%u;" : "%u", values[i]);
+    }
+    LONGS_EQUAL(0, spe_fput_u32_array(&column_fd, values, 21, ";"));
+    STRCMP_EQUAL(expected, column);
+}
+
+TEST(spe_column, SignedWithLongSeparator)
+{
+    const int32_t values[] = { -2147483647 - 1, -1, 0, 7, 2147483647 };
+
+    LONGS_EQUAL(0, spe_fput_i32_array(&column_fd, values, 5, " | "));
+    STRCMP_EQUAL("-2147483648 | -1 | 0 | 7 | 2147483647", column);
+}
+
+/* More than one chunk, and a separator split between chunks */
+TEST(spe_column, ManyValues)
+{
+    uint32_t values[100];
+    char expected[1200];
+    size_t len = 0;
+    int i;
+
+    for (i = 0; i < 100; i++) {
+        values[i] = (uint32_t)i * 43000007U;
+        len += (size_t)snprintf(&expected[len], sizeof(expected) - len,
+                                (i < 99) ? "%u, " : "%u", values[i]);
+    }
+    LONGS_EQUAL(0, spe_fput_u32_array(&column_fd, values, 100, ", "));
+    STRCMP_EQUAL(expected, column);
+}
+
+TEST(spe_column, Empty)
+{
+    const uint32_t values[] = { 1U };
+
+    LONGS_EQUAL(0, spe_fput_u32_array(&column_fd, values, 0, ","));
+    STRCMP_EQUAL("", column);
+    LONGS_EQUAL(0, spe_fput_u32_array(&column_fd, values, 1, ","));
+    STRCMP_EQUAL("1", column);
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_printf.h"
+#include "spe_crash.h"
+}
+
+/* Header and 32 characters of text */
+static uint32_t crash_mem[(sizeof(struct spe_crash) + 32) / sizeof(uint32_t)];
+static struct spe_crash *crash;
+static char text[64];
+
+static void
+crash_putc(char c)
+{
+    spe_crash_putc(crash, c);
+}
+
+static SPE_FILE crash_output = SPE_PRINTF_SETUP(crash_putc);
+
+/* Read the log as a string */
+static const char *
+crash_text(void)
+{
+    size_t len = spe_crash_read(crash, text, sizeof(text) - 1);
+    text[len] = 0;
+    return text;
+}
+
+TEST_GROUP(spe_crash)
+{
+    void setup() {
+        memset(crash_mem, 0xa5, sizeof(crash_mem));
+        crash = spe_crash_attach(crash_mem, sizeof(crash_mem));
+    }
+};
+
+TEST(spe_crash, StartsEmpty)
+{
+    CHECK(crash != NULL);
+    LONGS_EQUAL(32, crash->size);
+    STRCMP_EQUAL("", crash_text());
+}
+
+TEST(spe_crash, TooSmallOrUnaligned)
+{
+    POINTERS_EQUAL(NULL, spe_crash_attach(crash_mem, sizeof(struct spe_crash)));
+    POINTERS_EQUAL(NULL, spe_crash_attach((char *)crash_mem + 1, 40));
+    POINTERS_EQUAL(NULL, spe_crash_attach(NULL, 40));
+}
+
+TEST(spe_crash, Printf)
+{
+    LONGS_EQUAL(9, spe_crash_printf(crash, "HF pc=%d\n", 42));
+    LONGS_EQUAL(0, spe_fprintf(&crash_output, "r0=%x\n", 0xbeefU));
+    STRCMP_EQUAL("HF pc=42\nr0=beef\n", crash_text());
+}
+
+TEST(spe_crash, KeptOverAttach)
+{
+    spe_crash_printf(crash, "before reset\n");
+    crash = spe_crash_attach(crash_mem, sizeof(crash_mem));
+    STRCMP_EQUAL("before reset\n", crash_text());
+
+    /* A region of another size is not the same log */
+    crash = spe_crash_attach(crash_mem, sizeof(crash_mem) - 4);
+    STRCMP_EQUAL("", crash_text());
+}
+
+TEST(spe_crash, WrapsAround)
+{
+    spe_crash_printf(crash, "0123456789abcdefghij");
+    spe_crash_printf(crash, "ABCDEFGHIJKLMNOP");
+    STRCMP_EQUAL("456789abcdefghijABCDEFGHIJKLMNOP", crash_text());
+    LONGS_EQUAL(4, spe_crash_read(crash, text, 4));
+    MEMCMP_EQUAL("MNOP", text, 4);
+}
+
+TEST(spe_crash, LongerThanTheLog)
+{
+    spe_crash_printf(crash, "x");
+    spe_crash_write(crash, "0123456789abcdefghijklmnopqrstuvwxyzABCD", 40);
+    STRCMP_EQUAL("89abcdefghijklmnopqrstuvwxyzABCD", crash_text());
+}
+
+TEST(spe_crash, Clear)
+{
+    spe_crash_printf(crash, "handled\n");
+    spe_crash_clear(crash);
+    STRCMP_EQUAL("", crash_text());
+}
+
+/* A file mapping stands in for no-init RAM over a reset */
+TEST(spe_crash, FileMapping)
+{
+    char path[] = "/tmp/spe_crashXXXXXX";
+    const size_t size = 4096;
+    int fd = mkstemp(path);
+    void *mem;
+
+    CHECK(fd >= 0);
+    LONGS_EQUAL(0, ftruncate(fd, (off_t)size));
+    mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    CHECK(mem != MAP_FAILED);
+    crash = spe_crash_attach(mem, size);
+    spe_crash_printf(crash, "assert %s:%d\n", "main.c", 12);
+    munmap(mem, size);
+
+    mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    CHECK(mem != MAP_FAILED);
+    crash = spe_crash_attach(mem, size);
+    STRCMP_EQUAL("assert main.c:12\n", crash_text());
+    munmap(mem, size);
+    close(fd);
+    unlink(path);
+}
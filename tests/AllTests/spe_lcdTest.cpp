@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_lcd.h"
+}
+
+/* The bus traffic, moves as "@row,col" */
+static char bus[128];
+static size_t bus_len;
+
+static void
+lcd_move(int row, int col)
+{
+    bus_len += (size_t)snprintf(&bus[bus_len], sizeof(bus) - bus_len,
+                                "@%d,%d", row, col);
+}
+
+static void
+lcd_putc(char c)
+{
+    if (bus_len < sizeof(bus) - 1) {
+        bus[bus_len++] = c;
+    }
+}
+
+static char lcd_shadow[2 * 8];
+static char lcd_line[8 + 1];
+static struct spe_lcd lcd = SPE_LCD_SETUP(lcd_shadow, lcd_line, lcd_move,
+                                          lcd_putc);
+
+TEST_GROUP(spe_lcd)
+{
+    void setup() {
+        spe_lcd_invalidate(&lcd);
+        memset(bus, 0, sizeof(bus));
+        bus_len = 0;
+    }
+};
+
+TEST(spe_lcd, Geometry)
+{
+    LONGS_EQUAL(2, lcd.rows);
+    LONGS_EQUAL(8, lcd.cols);
+}
+
+TEST(spe_lcd, FirstPrintWritesWholeRow)
+{
+    LONGS_EQUAL(9, spe_lcd_printf(&lcd, 1, "T %d", 21));
+    STRCMP_EQUAL("@1,0T 21    ", bus);
+}
+
+TEST(spe_lcd, OnlyChangedCells)
+{
+    spe_lcd_printf(&lcd, 0, "T %3d C", 21);
+    spe_lcd_printf(&lcd, 1, "RH %d%%", 40);
+    bus_len = 0;
+    memset(bus, 0, sizeof(bus));
+
+    LONGS_EQUAL(0, spe_lcd_printf(&lcd, 0, "T %3d C", 21));
+    STRCMP_EQUAL("", bus);
+    LONGS_EQUAL(4, spe_lcd_printf(&lcd, 0, "T %3d C", 123));
+    STRCMP_EQUAL("@0,21@0,43", bus);
+}
+
+TEST(spe_lcd, ContiguousChangesNeedNoMove)
+{
+    spe_lcd_printf(&lcd, 0, "abcdefgh");
+    bus_len = 0;
+    memset(bus, 0, sizeof(bus));
+
+    LONGS_EQUAL(4, spe_lcd_printf(&lcd, 0, "abXYZfgh"));
+    STRCMP_EQUAL("@0,2XYZ", bus);
+}
+
+TEST(spe_lcd, ShorterTextClearsAndLongerIsCut)
+{
+    spe_lcd_printf(&lcd, 0, "123456789abc");
+    STRCMP_EQUAL("@0,012345678", bus);
+    bus_len = 0;
+    memset(bus, 0, sizeof(bus));
+
+    LONGS_EQUAL(7, spe_lcd_printf(&lcd, 0, "12\nignored"));
+    STRCMP_EQUAL("@0,2      ", bus);
+}
+
+TEST(spe_lcd, InvalidRow)
+{
+    LONGS_EQUAL(-1, spe_lcd_printf(&lcd, 2, "x"));
+    LONGS_EQUAL(-1, spe_lcd_printf(&lcd, -1, "x"));
+}
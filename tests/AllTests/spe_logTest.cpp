@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "CppUTest/TestHarness.h"
+
+/* Debug lines are removed at compile time in this file */
+#define SPE_LOG_MAX_LEVEL 3
+
+extern "C" {
+#include "spe_log.h"
+#include "output_mock.h"
+}
+
+SPE_LOG_MODULE_DEFINE(radio, SPE_LOG_LEVEL_WARN);
+
+static int nuf_evaluated;
+
+static int
+evaluate(int value)
+{
+    nuf_evaluated++;
+    return value;
+}
+
+static char log_out[64];
+static size_t log_len;
+
+static void
+log_putc(char c)
+{
+    if (log_len < sizeof(log_out) - 1) {
+        log_out[log_len++] = c;
+    }
+}
+
+static SPE_FILE crash_log = SPE_PRINTF_SETUP(log_putc);
+static SPE_FILE console = SPE_PRINTF_SETUP(output_mock_char_input);
+
+static char tee_buf[32];
+static const struct spe_tee_sink tee_sinks[] = {
+    { &console, 0xffU },
+    { &crash_log, SPE_LOG_MASK(SPE_LOG_LEVEL_ERROR) },
+};
+static struct spe_tee tee = SPE_TEE_SETUP(tee_buf, tee_sinks);
+
+TEST_GROUP(spe_log)
+{
+    void setup() {
+        output_mock_setup();
+        memset(log_out, 0, sizeof(log_out));
+        log_len = 0;
+        nuf_evaluated = 0;
+        SPE_LOG_SET_LEVEL(radio, SPE_LOG_LEVEL_WARN);
+        spe_log_set_output(NULL);
+    }
+    void teardown() {
+        output_mock_destroy();
+    }
+};
+
+TEST(spe_log, PrefixAndNewline)
+{
+    SPE_LOG_ERROR(radio, "rssi %d", -70);
+    STRCMP_EQUAL("E/radio: rssi -70\n", output_mock_get_string());
+}
+
+TEST(spe_log, NoArguments)
+{
+    SPE_LOG_WARN(radio, "lost");
+    STRCMP_EQUAL("W/radio: lost\n", output_mock_get_string());
+}
+
+TEST(spe_log, RuntimeLevelDoesNotEvaluate)
+{
+    SPE_LOG_INFO(radio, "rssi %d", evaluate(-70));
+    LONGS_EQUAL(0, nuf_evaluated);
+    STRCMP_EQUAL("", output_mock_get_string());
+
+    SPE_LOG_SET_LEVEL(radio, SPE_LOG_LEVEL_DEBUG);
+    SPE_LOG_INFO(radio, "rssi %d", evaluate(-70));
+    LONGS_EQUAL(1, nuf_evaluated);
+    STRCMP_EQUAL("I/radio: rssi -70\n", output_mock_get_string());
+}
+
+TEST(spe_log, CompileTimeLevel)
+{
+    SPE_LOG_SET_LEVEL(radio, SPE_LOG_LEVEL_DEBUG);
+    SPE_LOG_DEBUG(radio, "state %d", evaluate(1));
+    LONGS_EQUAL(0, nuf_evaluated);
+    STRCMP_EQUAL("", output_mock_get_string());
+}
+
+TEST(spe_log, Tee)
+{
+    spe_log_set_tee(&tee);
+    SPE_LOG_WARN(radio, "low");
+    SPE_LOG_ERROR(radio, "down");
+    STRCMP_EQUAL("W/radio: low\nE/radio: down\n", output_mock_get_string());
+    STRCMP_EQUAL("E/radio: down\n", log_out);
+}
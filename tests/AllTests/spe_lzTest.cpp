@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_printf.h"
+#include "spe_lz.h"
+}
+
+/* Flash area, erased */
+static unsigned char flash[2048];
+static size_t flash_len;
+static int flash_writes;
+
+static void
+flash_append(const unsigned char *block, size_t len)
+{
+    if (flash_len + len <= sizeof(flash)) {
+        memcpy(&flash[flash_len], block, len);
+    }
+    flash_len += len;
+    flash_writes++;
+}
+
+static char lz_in[256];
+static unsigned char lz_out[SPE_LZ_OUT_SIZE(sizeof(lz_in))];
+static struct spe_lz lz = SPE_LZ_SETUP(lz_in, lz_out, flash_append);
+
+static void
+lz_putc(char c)
+{
+    spe_lz_putc(&lz, c);
+}
+
+static SPE_FILE flash_log = SPE_PRINTF_SETUP(lz_putc);
+
+/* Whole log decoded block by block, \0 terminated */
+static char text[2048];
+
+static long
+decode_all(void)
+{
+    size_t pos = 0;
+    long total = 0;
+
+    while (pos < flash_len) {
+        size_t used;
+        long n = spe_lz_decode(&flash[pos], flash_len - pos, &text[total],
+                               sizeof(text) - 1 - (size_t)total, &used);
+        if (n < 0) {
+            return -1;
+        }
+        total += n;
+        pos += used;
+    }
+    text[total] = '\0';
+    return total;
+}
+
+TEST_GROUP(spe_lz)
+{
+    void setup() {
+        memset(flash, 0xff, sizeof(flash));
+        flash_len = 0;
+        flash_writes = 0;
+    }
+};
+
+TEST(spe_lz, RoundTripLog)
+{
+    char expected[2048];
+    size_t len = 0;
+    int i;
+
+    for (i = 0; i < 40; i++) {
+        spe_fprintf(&flash_log, "%05d I/sensor: temperature %d.%d C\n",
+                    1000 + i * 250, 21 + i % 3, i % 10);
+        len += (size_t)snprintf(&expected[len], sizeof(expected) - len,
+                                "%05d I/sensor: temperature %d.%d C\n",
+                                1000 + i * 250, 21 + i % 3, i % 10);
+    }
+    spe_lz_flush(&lz);
+
+    LONGS_EQUAL(6, flash_writes);
+    LONGS_EQUAL((long)len, decode_all());
+    STRCMP_EQUAL(expected, text);
+    /* Log text compresses to less than half */
+    CHECK(flash_len * 2 < len);
+}
+
+TEST(spe_lz, FlushEmptyWritesNothing)
+{
+    spe_lz_flush(&lz);
+    LONGS_EQUAL(0, flash_writes);
+}
+
+TEST(spe_lz, LongRepeatsOverlap)
+{
+    spe_fprintf(&flash_log, "%s%s", "----------------------------------",
+                "-----------------------------------------------------");
+    spe_lz_flush(&lz);
+
+    LONGS_EQUAL('Z', flash[0]);
+    LONGS_EQUAL(87, decode_all());
+    LONGS_EQUAL(0, strspn(text, "-") - 87);
+}
+
+TEST(spe_lz, IncompressibleIsStored)
+{
+    spe_fprintf(&flash_log, "0123456789abcdef");
+    spe_lz_flush(&lz);
+
+    LONGS_EQUAL('S', flash[0]);
+    LONGS_EQUAL(SPE_LZ_HEADER + 16, flash_len);
+    LONGS_EQUAL(16, decode_all());
+    STRCMP_EQUAL("0123456789abcdef", text);
+}
+
+TEST(spe_lz, EndOfLog)
+{
+    LONGS_EQUAL(-1, spe_lz_decode(flash, sizeof(flash), text, sizeof(text),
+                                  NULL));
+}
+
+TEST(spe_lz, DamagedBlock)
+{
+    spe_fprintf(&flash_log, "abcabcabcabcabcabc");
+    spe_lz_flush(&lz);
+
+    /* Match reaching before the start of the block */
+    flash[SPE_LZ_HEADER + 5] = 0x0f;
+    LONGS_EQUAL(-1, spe_lz_decode(flash, flash_len, text, sizeof(text),
+                                  NULL));
+}
+
+TEST(spe_lz, OutputTooSmall)
+{
+    spe_fprintf(&flash_log, "abcabcabcabcabcabc");
+    spe_lz_flush(&lz);
+
+    LONGS_EQUAL(-1, spe_lz_decode(flash, flash_len, text, 17, NULL));
+    LONGS_EQUAL(18, spe_lz_decode(flash, flash_len, text, 18, NULL));
+}
@@ -21,10 +21,12 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <limits.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <wchar.h>
 #include "CppUTest/TestHarness.h"
 
 extern "C" {
@@ -186,3 +188,697 @@ TEST(spe_printf, snprintfTooShortWithdata)
     LONGS_EQUAL(15, spe_snprintf(string, 15, "Hello World!%d", 1234));
     STRCMP_EQUAL("Hello World!12", string);
 }
+
+TEST(spe_printf, snprintfSizeZero)
+{
+    char string[4] = "abc";
+    LONGS_EQUAL(0, spe_snprintf(string, 0, "Hello %d", 1234));
+    STRCMP_EQUAL("abc", string);
+    LONGS_EQUAL(0, spe_snprintf(NULL, 0, "Hello %d", 1234));
+}
+
+TEST(spe_printf, snprintfSizeOne)
+{
+    char string[4] = "abc";
+    LONGS_EQUAL(1, spe_snprintf(string, 1, "Hello %d", 1234));
+    STRCMP_EQUAL("", string);
+}
+
+TEST(spe_printf, snprintfIntegerExactFit)
+{
+    char string[10];
+    LONGS_EQUAL(10, spe_snprintf(string, 10, "%#08x!", 0xabcu));
+    STRCMP_EQUAL("0x000abc!", string);
+    LONGS_EQUAL(6, spe_snprintf(string, 6, "%5.4d", -12));
+    STRCMP_EQUAL("-0012", string);
+}
+
+TEST(spe_printf, snprintfIntegerOneShort)
+{
+    char string[5];
+    LONGS_EQUAL(5, spe_snprintf(string, 5, "%5.4d", -12));
+    STRCMP_EQUAL("-001", string);
+    LONGS_EQUAL(5, spe_snprintf(string, 5, "%lb", 0x3fUL));
+    STRCMP_EQUAL("1111", string);
+}
+
+/* Digit counts around every power of ten */
+TEST(spe_printf, snprintfDecimalDigitBoundaries)
+{
+    char string[48], expected[48];
+    unsigned long power = 1UL;
+
+    while (1) {
+        snprintf(expected, sizeof(expected), "%lu %lu", power - 1UL, power);
+        spe_snprintf(string, sizeof(string), "%lu %lu", power - 1UL, power);
+        STRCMP_EQUAL(expected, string);
+        snprintf(expected, sizeof(expected), "%u", (unsigned int)power);
+        spe_snprintf(string, sizeof(string), "%u", (unsigned int)power);
+        STRCMP_EQUAL(expected, string);
+        if (power > ULONG_MAX / 10UL) {
+            break;
+        }
+        power *= 10UL;
+    }
+    snprintf(expected, sizeof(expected), "%lu", ULONG_MAX);
+    spe_snprintf(string, sizeof(string), "%lu", ULONG_MAX);
+    STRCMP_EQUAL(expected, string);
+}
+
+TEST(spe_printf, snprintfLongWidthTruncated)
+{
+    char string[6];
+    LONGS_EQUAL(6, spe_snprintf(string, 6, "%2000000000d", 1234));
+    STRCMP_EQUAL("     ", string);
+}
+
+TEST(spe_printf, snprintfLongZeroPadTruncated)
+{
+    char string[6];
+    LONGS_EQUAL(6, spe_snprintf(string, 6, "%0*d", 2000000000, 1234));
+    STRCMP_EQUAL("00000", string);
+    LONGS_EQUAL(6, spe_snprintf(string, 6, "%.2000000000lu", 1234UL));
+    STRCMP_EQUAL("00000", string);
+}
+
+TEST(spe_printf, TimestampSeconds)
+{
+    unsigned long long t = 1700000000ULL;
+    LONGS_EQUAL(0, spe_printf("[%pTs]", &t));
+    STRCMP_EQUAL("[2023-11-14T22:13:20Z]", output_mock_get_string());
+}
+
+TEST(spe_printf, TimestampLastYear)
+{
+    unsigned long long t = 253402300799ULL;
+    unsigned long long ms = 253402300800000ULL;
+    unsigned long long far = 1614865550270000000ULL;
+
+    LONGS_EQUAL(0, spe_printf("%pTs", &t));
+    STRCMP_EQUAL("9999-12-31T23:59:59Z", output_mock_get_string());
+    t++;
+    LONGS_EQUAL(-1, spe_printf("%pTs", &t));
+    LONGS_EQUAL(-1, spe_printf("%pTm", &ms));
+    LONGS_EQUAL(-1, spe_printf("%pTs", &far));
+}
+
+TEST(spe_printf, TimestampLeapDay)
+{
+    unsigned long long t = 951782400ULL;
+    LONGS_EQUAL(0, spe_printf("%pTs", &t));
+    STRCMP_EQUAL("2000-02-29T00:00:00Z", output_mock_get_string());
+}
+
+TEST(spe_printf, TimestampMilliAndMicroSeconds)
+{
+    unsigned long long ms = 1700000000012ULL;
+    unsigned long long us = 1700000000000345ULL;
+    LONGS_EQUAL(0, spe_printf("%pTm %pTu", &ms, &us));
+    STRCMP_EQUAL("2023-11-14T22:13:20.012Z 2023-11-14T22:13:20.000345Z",
+                 output_mock_get_string());
+}
+
+TEST(spe_printf, TimestampCachedPrefix)
+{
+    unsigned long long t1 = 1700000000ULL;
+    unsigned long long t2 = 1700000399ULL;
+    unsigned long long t3 = 1700086400ULL;
+    LONGS_EQUAL(0, spe_printf("%pTs|%pTs|", &t1, &t2));
+    LONGS_EQUAL(0, spe_printf("%pTs", &t3));
+    STRCMP_EQUAL("2023-11-14T22:13:20Z|2023-11-14T22:19:59Z|"
+                 "2023-11-15T22:13:20Z", output_mock_get_string());
+}
+
+TEST(spe_printf, Duration)
+{
+    unsigned long long s = 59ULL;
+    unsigned long long ms = 3723004ULL;
+    unsigned long long us = 360000000000ULL;
+    LONGS_EQUAL(0, spe_printf("%pDs %pDm %pDu", &s, &ms, &us));
+    STRCMP_EQUAL("00:00:59 01:02:03.004 100:00:00.000000",
+                 output_mock_get_string());
+}
+
+TEST(spe_printf, TimestampBadUnit)
+{
+    unsigned long long t = 0ULL;
+    LONGS_EQUAL(-1, spe_printf("%pTx", &t));
+}
+
+TEST(spe_printf, snprintfTimestamp)
+{
+    char string[25];
+    unsigned long long t = 0ULL;
+    LONGS_EQUAL(23, spe_snprintf(string, 25, "<%pTs>", &t));
+    STRCMP_EQUAL("<1970-01-01T00:00:00Z>", string);
+}
+
+static int
+print_ipv4(SPE_FILE *fd, const struct spe_conv_spec *spec, const void *arg)
+{
+    const unsigned char *ip = (const unsigned char *)arg;
+    (void)spec;
+    spe_fprintf(fd, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return 0;
+}
+
+/* %pE followed by 'u' prints the name in upper case */
+static int
+print_enum(SPE_FILE *fd, const struct spe_conv_spec *spec, const void *arg)
+{
+    static const char *names[] = { "off", "on" };
+    const char *name = names[*(const int *)arg];
+    int upper = (spec->suffix[0] == 'u');
+
+    for (int i = (int)strlen(name); i < spec->min_width; i++) {
+        spe_fputc(' ', fd);
+    }
+    if (!upper) {
+        spe_fputs(name, fd);
+        return 0;
+    }
+    for (; *name; name++) {
+        spe_fputc(*name - 'a' + 'A', fd);
+    }
+    return 1;
+}
+
+TEST(spe_printf, CustomConversion)
+{
+    const unsigned char ip[] = { 192, 168, 0, 17 };
+    LONGS_EQUAL(0, spe_register_conversion('I', print_ipv4));
+    LONGS_EQUAL(0, spe_printf("ip=%pI.", ip));
+    STRCMP_EQUAL("ip=192.168.0.17.", output_mock_get_string());
+    LONGS_EQUAL(0, spe_register_conversion('I', NULL));
+}
+
+TEST(spe_printf, CustomConversionWithSuffixAndWidth)
+{
+    int state = 1;
+    LONGS_EQUAL(0, spe_register_conversion('E', print_enum));
+    LONGS_EQUAL(0, spe_printf("[%pE][%4pEu]", &state, &state));
+    STRCMP_EQUAL("[on][  ON]", output_mock_get_string());
+    LONGS_EQUAL(0, spe_register_conversion('E', NULL));
+}
+
+static int nuf_counted = 0;
+
+static int
+count_conversion(SPE_FILE *fd, const struct spe_conv_spec *spec,
+                 const void *arg)
+{
+    (void)spec;
+    nuf_counted++;
+    return spe_fputs((const char *)arg, fd);
+}
+
+/* Once the string is full the remaining conversions are skipped */
+TEST(spe_printf, snprintfStopsWhenFull)
+{
+    char string[8];
+    nuf_counted = 0;
+    LONGS_EQUAL(0, spe_register_conversion('C', count_conversion));
+    LONGS_EQUAL(8, spe_snprintf(string, 8, "%pC%pC%pC%pC", "abcd", "efgh",
+                                "ijkl", "mnop"));
+    STRCMP_EQUAL("abcdefg", string);
+    LONGS_EQUAL(2, nuf_counted);
+    LONGS_EQUAL(0, spe_register_conversion('C', NULL));
+}
+
+/* Without a registration it is a plain pointer followed by text */
+TEST(spe_printf, CustomConversionNotRegistered)
+{
+    int state = 1;
+    do_comparison("%pE", (void *)&state);
+}
+
+TEST(spe_printf, CustomConversionBuiltinAndInvalid)
+{
+    LONGS_EQUAL(-1, spe_register_conversion('T', print_ipv4));
+    LONGS_EQUAL(-1, spe_register_conversion('\0', print_ipv4));
+    LONGS_EQUAL(-1, spe_register_conversion((char)0xe5, print_ipv4));
+}
+
+TEST(spe_printf, fputcAndfputs)
+{
+    LONGS_EQUAL('a', spe_fputc('a', spe_stdout));
+    LONGS_EQUAL(0, spe_fputs("bc", spe_stdout));
+    STRCMP_EQUAL("abc", output_mock_get_string());
+}
+
+TEST(spe_printf, fwrite)
+{
+    LONGS_EQUAL(3, spe_fwrite("a\0bc", 1, 3, spe_stdout));
+    LONGS_EQUAL(1, spe_fwrite("cd", 2, 1, spe_stdout));
+    LONGS_EQUAL(5, output_mock_get_string_length());
+    MEMCMP_EQUAL("a\0bcd", output_mock_get_string(), 5);
+}
+
+TEST(spe_printf, ZeroFlag)
+{
+    do_comparison("[%05d] [%05d] [%08lx] [%04u]", 12, -12, 0xabcdUL, 7);
+}
+
+TEST(spe_printf, PrecisionWithoutWidth)
+{
+    do_comparison("[%.3d] [%.5u] [%.4x]", -7, 42, 0xfu);
+}
+
+TEST(spe_printf, WidthAndPrecisionAsParameters)
+{
+    do_comparison("[%*d] [%.*u] [%*.*d]", 6, -12, 4, 3, 8, 5, 99);
+}
+
+TEST(spe_printf, DoublePrecisionZeroAndZeroFlag)
+{
+    do_comparison("[%.0f] [%5.0f] [%08.2f] [%08.3f]", 12.25, 3.25, -3.5, 2.5);
+}
+
+TEST(spe_printf, InvalidConversions)
+{
+    /* Not literals, to keep gcc's format checking quiet */
+    const char *two_dots = "%5.5.5d";
+    const char *unterminated = "%-5";
+    LONGS_EQUAL(-1, spe_printf(two_dots, 1));
+    LONGS_EQUAL(-1, spe_printf("%llu", 1ULL));
+    LONGS_EQUAL(-1, spe_printf(unterminated, 1));
+}
+
+/* Left adjustment and sign flags are not supported, rather than ignored */
+TEST(spe_printf, LeftAndSignFlagsRejected)
+{
+    const char *left = "[%-5d]";
+    const char *plus = "[%+d]";
+    const char *space = "[% d]";
+    const char *zero_left = "[%0-5d]";
+    volatile int most_negative = INT_MIN;
+    char string[16] = "untouched";
+
+    LONGS_EQUAL(-1, spe_printf(left, 12));
+    LONGS_EQUAL(-1, spe_printf(plus, 12));
+    LONGS_EQUAL(-1, spe_printf(space, 12));
+    LONGS_EQUAL(-1, spe_printf(zero_left, 12));
+    LONGS_EQUAL(-1, spe_snprintf(string, sizeof(string), "[%*d]", -5, 12));
+    LONGS_EQUAL(-1, spe_snprintf(string, sizeof(string), "[%*s]",
+                                 most_negative, "x"));
+    LONGS_EQUAL(3, spe_snprintf(string, sizeof(string), "%*d", 0, 12));
+    STRCMP_EQUAL("12", string);
+}
+
+TEST(spe_printf, OctalAndBinary)
+{
+    do_comparison("[%o] [%6o] [%lo] [%b] [%012b] [%.4b]",
+                  8u, 0755u, 01234567012UL, 5u, 0xa5u, 1u);
+}
+
+TEST(spe_printf, LongBinary)
+{
+    do_comparison("[%lb]", 0xf0f0UL);
+}
+
+TEST(spe_printf, AlternateForm)
+{
+    do_comparison("[%#x] [%#X] [%#08x] [%#10lx] [%#x] [%#b]",
+                  0xabu, 0xabu, 0xffu, 0xdeadUL, 0u, 6u);
+}
+
+TEST(spe_printf, AlternateFormPrecision)
+{
+    do_comparison("[%#.6x]", 0x1u);
+}
+
+TEST(spe_printf, HexExtremes)
+{
+    do_comparison("[%x] [%lx] [%lX] [%x] [%.1x]",
+                  0xffffffffu, ~0UL, 0x8000000000000000UL, 0u, 0u);
+}
+
+TEST(spe_printf, Pointer)
+{
+    int variable;
+    do_comparison("[%p] [%20p] [%p] [%8p]", (void *)&variable,
+                  (void *)&variable, (void *)NULL, (void *)NULL);
+}
+
+TEST(spe_printf, PointerFollowedByText)
+{
+    int variable;
+    do_comparison("[%pabc] [%pZ]", (void *)&variable, (void *)&variable);
+}
+
+TEST(spe_printf, ArgPack)
+{
+    char string[64];
+    const struct spe_arg args[] = {
+        SPE_ARG_INT(-12), SPE_ARG_UINT(0xabcu), SPE_ARG_LONG(-1234567890L),
+        SPE_ARG_STRING("abc"), SPE_ARG_INT('x'), SPE_ARG_DOUBLE(1.5),
+    };
+    LONGS_EQUAL(33, spe_snprintf_args(string, sizeof(string),
+                                      "%d %#x %ld %s %c %.2f", args, 6));
+    STRCMP_EQUAL("-12 0xabc -1234567890 abc x 1.50", string);
+}
+
+/* The same pack rendered again, with another format */
+TEST(spe_printf, ArgPackRenderedTwice)
+{
+    const struct spe_arg args[] = { SPE_ARG_INT(8), SPE_ARG_UINT(255u) };
+    LONGS_EQUAL(0, spe_fprintf_args(spe_stdout, "[%*x]", args, 2));
+    LONGS_EQUAL(0, spe_fprintf_args(spe_stdout, "[%d %u]", args, 2));
+    STRCMP_EQUAL("[      ff][8 255]", output_mock_get_string());
+}
+
+/* A timestamp by value, no pointer to keep valid */
+TEST(spe_printf, ArgPackTimestampByValue)
+{
+    char string[48];
+    unsigned long long t = 86400ULL;
+    const struct spe_arg args[] = {
+        SPE_ARG_U64(951782400ULL), SPE_ARG_POINTER(&t),
+    };
+    LONGS_EQUAL(42, spe_snprintf_args(string, sizeof(string),
+                                      "%pTs %pTs", args, 2));
+    STRCMP_EQUAL("2000-02-29T00:00:00Z 1970-01-02T00:00:00Z", string);
+}
+
+TEST(spe_printf, ArgPackMissingOrWrongType)
+{
+    const struct spe_arg args[] = { SPE_ARG_STRING("abc"), SPE_ARG_INT(1) };
+    LONGS_EQUAL(-1, spe_fprintf_args(spe_stdout, "%s %d %d", args, 2));
+    LONGS_EQUAL(-1, spe_fprintf_args(spe_stdout, "%d", args, 2));
+    LONGS_EQUAL(-1, spe_fprintf_args(spe_stdout, "%s %ld", args, 2));
+}
+
+/* Lengths counted match what is printed, on both sides of every power */
+TEST(spe_printf, ArgLengthLikeSnprintf)
+{
+    static const char conversions[] = "duxXob";
+    char string[80];
+    unsigned long power;
+    int k;
+
+    for (power = 1UL; power; power = (power > ULONG_MAX / 7UL) ? 0 : power * 7UL) {
+        const unsigned long values[] = { power - 1UL, power, 0UL - power };
+
+        for (k = 0; k < 6; k++) {
+            const char fmt[] = { '%', 'l', conversions[k], '\0' };
+            int v;
+
+            for (v = 0; v < 3; v++) {
+                const struct spe_arg arg = SPE_ARG_ULONG(values[v]);
+                const struct spe_arg sarg = SPE_ARG_LONG((long)values[v]);
+                const struct spe_arg *a = (conversions[k] == 'd') ? &sarg : &arg;
+
+                LONGS_EQUAL(spe_snprintf_args(string, sizeof(string), fmt,
+                                              a, 1) - 1,
+                            spe_arg_length(a, conversions[k]));
+            }
+        }
+    }
+    const struct spe_arg imin = SPE_ARG_INT(INT_MIN);
+    const struct spe_arg str = SPE_ARG_STRING("abc");
+    LONGS_EQUAL(snprintf(string, sizeof(string), "%d", INT_MIN),
+                spe_arg_length(&imin, 'd'));
+    LONGS_EQUAL(3, spe_arg_length(&str, 's'));
+    LONGS_EQUAL(-1, spe_arg_length(&str, 'd'));
+    LONGS_EQUAL(-1, spe_arg_length(&imin, 's'));
+}
+
+TEST(spe_printf, QuotedC)
+{
+    LONGS_EQUAL(0, spe_printf("%pQ", "say \"hi\"\\\n\t\x1b" "1\x7f\xc3\xa5"));
+    STRCMP_EQUAL("\"say \\\"hi\\\"\\\\\\n\\t\\0331\\177\xc3\xa5\"",
+                 output_mock_get_string());
+}
+
+TEST(spe_printf, QuotedJson)
+{
+    LONGS_EQUAL(0, spe_printf("{\"k\":%pJ}", "a\"b\\c\b\f\r\x01\x7f"));
+    STRCMP_EQUAL("{\"k\":\"a\\\"b\\\\c\\b\\f\\r\\u0001\x7f\"}",
+                 output_mock_get_string());
+}
+
+TEST(spe_printf, QuotedNull)
+{
+    LONGS_EQUAL(0, spe_printf("%pQ %pJ", (char *)NULL, (char *)NULL));
+    STRCMP_EQUAL("(null) null", output_mock_get_string());
+}
+
+/* Escapes on both sides of every position within an eight byte word */
+TEST(spe_printf, snprintfQuotedLong)
+{
+    char string[64];
+    LONGS_EQUAL(40, spe_snprintf(string, sizeof(string), "%pJ",
+                                 "0123456\"89abcdef\n1234567890abcdef\\"));
+    STRCMP_EQUAL("\"0123456\\\"89abcdef\\n1234567890abcdef\\\\\"", string);
+}
+
+TEST(spe_printf, snprintfQuotedTruncated)
+{
+    char string[8];
+    LONGS_EQUAL(8, spe_snprintf(string, sizeof(string), "%pQ",
+                                "abcdefghijklmnop"));
+    STRCMP_EQUAL("\"abcdef", string);
+}
+
+/* Test vectors of RFC 4648 */
+TEST(spe_printf, Base64)
+{
+    const char *foobar = "foobar";
+    LONGS_EQUAL(0, spe_printf("[%*pB][%1pB][%2pB][%3pB][%4pB][%*pB]",
+                              0, foobar, foobar, foobar, foobar, foobar,
+                              6, foobar));
+    STRCMP_EQUAL("[][Zg==][Zm8=][Zm9v][Zm9vYg==][Zm9vYmFy]",
+                 output_mock_get_string());
+}
+
+/* Test vector of the Z85 specification, and a short last group */
+TEST(spe_printf, Base85)
+{
+    const unsigned char hello[] = {
+        0x86, 0x4f, 0xd2, 0x6f, 0xb5, 0x59, 0xf7, 0x5b,
+    };
+    LONGS_EQUAL(0, spe_printf("%8pA %*pA", hello, 3, hello));
+    STRCMP_EQUAL("HelloWorld Helj", output_mock_get_string());
+}
+
+TEST(spe_printf, BlobWithoutLength)
+{
+    LONGS_EQUAL(-1, spe_printf("%pB", "abc"));
+}
+
+TEST(spe_printf, BlobNegativeLength)
+{
+    LONGS_EQUAL(-1, spe_printf("%*pB", -3, "abc"));
+    LONGS_EQUAL(-1, spe_printf("%*pA", -4, "abcd"));
+    LONGS_EQUAL(-1, spe_printf("%*pB", INT_MIN, "abc"));
+    STRCMP_EQUAL("", output_mock_get_string());
+}
+
+TEST(spe_printf, BlobNull)
+{
+    LONGS_EQUAL(0, spe_printf("%3pB %3pA", (void *)NULL, (void *)NULL));
+    STRCMP_EQUAL("(nil) (nil)", output_mock_get_string());
+}
+
+/* Longer than the chunk the encoding goes through */
+TEST(spe_printf, snprintfBlobLong)
+{
+    unsigned char data[100];
+    char string[160];
+    int i;
+
+    for (i = 0; i < 100; i++) {
+        data[i] = (unsigned char)i;
+    }
+    LONGS_EQUAL(137, spe_snprintf(string, sizeof(string), "%*pB", 100,
+                                  data));
+    STRCMP_EQUAL("AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygp"
+                 "KissLS4vMDEyMzQ1Njc4OTo7PD0+P0BBQkNERUZHSElKS0xNTk9QUVJT"
+                 "VFVWV1hZWltcXV5fYGFiYw==", string);
+    LONGS_EQUAL(126, spe_snprintf(string, sizeof(string), "%*pA", 100,
+                                  data));
+    STRCMP_EQUAL("009c61o!#m2NH?C3>iWS5d]J*6CRx17-skh9337xar.{NbQB=+c[cR@e"
+                 "g&FcfFLssg=mfIi5%2YjuU>)kTv.7l}6Nnnj=ADoIFnTp/ga?r8($2sx"
+                 "O*itWpVyu$0IO", string);
+}
+
+/* Reference, a digit at a time */
+static void
+u128_to_string(unsigned __int128 value, char *string)
+{
+    char digits[48];
+    int n = 0;
+
+    do {
+        digits[n++] = (char)('0' + (int)(value % 10U));
+        value /= 10U;
+    } while (value);
+    while (n > 0) {
+        *string++ = digits[--n];
+    }
+    *string = '\0';
+}
+
+TEST(spe_printf, BigU128)
+{
+    const struct spe_u128 max = { ~0ULL, ~0ULL };
+    const struct spe_u128 chunk = { 1000000000ULL, 0ULL };
+    const struct spe_u128 zero = { 0ULL, 0ULL };
+    LONGS_EQUAL(0, spe_printf("%pW|%pW|%pW|%5pW", &max, &chunk, &zero,
+                              &zero));
+    STRCMP_EQUAL("340282366920938463463374607431768211455|1000000000|0|"
+                 "    0", output_mock_get_string());
+}
+
+TEST(spe_printf, BigS128)
+{
+    const struct spe_u128 min = { 0ULL, 1ULL << 63 };
+    const struct spe_u128 minus_one = { ~0ULL, ~0ULL };
+    const struct spe_u128 max = { ~0ULL, ~0ULL >> 1 };
+    LONGS_EQUAL(0, spe_printf("%pWd|%pWd|%pWd|%4pWd.", &min, &minus_one,
+                              &max, &minus_one));
+    STRCMP_EQUAL("-170141183460469231731687303715884105728|-1|"
+                 "170141183460469231731687303715884105727|  -1.",
+                 output_mock_get_string());
+}
+
+/* Powers of ten and their neighbours, where chunks carry zeros */
+TEST(spe_printf, snprintfBigLikeReference)
+{
+    unsigned __int128 power = 1U;
+    char string[48];
+    char expected[48];
+    int i, d;
+
+    for (i = 0; i < 39; i++) {
+        for (d = -1; d <= 1; d++) {
+            const unsigned __int128 value = power + (unsigned __int128)d;
+
+            u128_to_string(value, expected);
+            LONGS_EQUAL((long)strlen(expected) + 1,
+                        spe_snprintf(string, sizeof(string), "%pW", &value));
+            STRCMP_EQUAL(expected, string);
+        }
+        power *= 10U;
+    }
+}
+
+TEST(spe_printf, BigintWords)
+{
+    uint32_t words[SPE_BIGINT_MAX_WORDS];
+    int i;
+
+    for (i = 0; i < SPE_BIGINT_MAX_WORDS; i++) {
+        words[i] = 0xffffffffU;
+    }
+    LONGS_EQUAL(0, spe_fput_bigint(spe_stdout, words, 8));
+    STRCMP_EQUAL("1157920892373161954235709850086879078532699846656405640394"
+                 "57584007913129639935", output_mock_get_string());
+    LONGS_EQUAL(-1, spe_fput_bigint(spe_stdout, words, 0));
+    LONGS_EQUAL(-1, spe_fput_bigint(spe_stdout, words,
+                                    SPE_BIGINT_MAX_WORDS + 1));
+}
+
+TEST(spe_printf, snprintfBlobTruncated)
+{
+    char string[8];
+    LONGS_EQUAL(8, spe_snprintf(string, sizeof(string), "%6pB",
+                                "foobar"));
+    STRCMP_EQUAL("Zm9vYmF", string);
+}
+
+TEST(spe_printf, Utf8Precision)
+{
+    /* a, n with tilde, b, euro sign, c */
+    static const char text[] = "a\xc3\xb1" "b\xe2\x82\xac" "c";
+
+    spe_printf("[%.3s]", text);
+    spe_printf("[%.4s]", text);
+    spe_printf("[%.0s]", text);
+    spe_printf("[%.9s]", text);
+    STRCMP_EQUAL("[a\xc3\xb1" "b][a\xc3\xb1" "b\xe2\x82\xac][][" "a\xc3\xb1"
+                 "b\xe2\x82\xac" "c]", output_mock_get_string());
+}
+
+TEST(spe_printf, Utf8PrecisionLongRuns)
+{
+    spe_printf("[%.12s]", "0123456789abcdefghij");
+    spe_printf("[%.9s]", "abcdefg\xe2\x82\xac" "hijklmnop");
+    spe_printf("[%*.*s]", 0, 2, "xyz");
+    STRCMP_EQUAL("[0123456789ab][abcdefg\xe2\x82\xac" "h][xy]",
+                 output_mock_get_string());
+}
+
+/* A broken sequence counts one code point per byte */
+TEST(spe_printf, Utf8PrecisionInvalid)
+{
+    spe_printf("[%.2s]", "\xe2\x82" "ab");
+    spe_printf("[%.1s]", "\xff\xfe");
+    STRCMP_EQUAL("[\xe2\x82][\xff]", output_mock_get_string());
+}
+
+/* Not read past the code points printed */
+TEST(spe_printf, Utf8PrecisionUnterminated)
+{
+    const char text[4] = { 'a', 'b', 'c', 'd' };
+
+    spe_printf("[%.1s]", text);
+    STRCMP_EQUAL("[a]", output_mock_get_string());
+}
+
+TEST(spe_printf, ArgLengthCodePoints)
+{
+    const struct spe_arg str = SPE_ARG_STRING("a\xc3\xb1" "b\xe2\x82\xac");
+
+    LONGS_EQUAL(4, spe_arg_length(&str, 's'));
+}
+
+TEST(spe_printf, WideString)
+{
+    spe_printf("[%ls]", L"a\u00f1\u20ac\U0001f600");
+    spe_printf("[%.5ls]", L"\u00f1\u20acx");
+    STRCMP_EQUAL("[a\xc3\xb1\xe2\x82\xac\xf0\x9f\x98\x80][\xc3\xb1\xe2\x82\xac]",
+                 output_mock_get_string());
+}
+
+/* The precision is in bytes, a character that doesn't fit is left out */
+TEST(spe_printf, WideStringPrecisionBytes)
+{
+    spe_printf("[%.3ls]", L"\u00f1\u20ac");
+    spe_printf("[%.2ls]", L"a\u20ac");
+    spe_printf("[%.0ls]", L"a");
+    spe_printf("[%.4ls]", L"ab\u00f1x");
+    STRCMP_EQUAL("[\xc3\xb1][a][][ab\xc3\xb1]", output_mock_get_string());
+}
+
+/* Through a pack, since gcc rejects a NULL %ls */
+TEST(spe_printf, WideStringNull)
+{
+    const struct spe_arg none = SPE_ARG_POINTER(NULL);
+    char string[16];
+
+    LONGS_EQUAL(9, spe_snprintf_args(string, sizeof(string), "[%ls]",
+                                     &none, 1));
+    STRCMP_EQUAL("[(null)]", string);
+}
+
+TEST(spe_printf, WideChar)
+{
+    spe_printf("%lc%lc%lc", (wint_t)'x', (wint_t)0x20ac, (wint_t)0xd800);
+    STRCMP_EQUAL("x\xe2\x82\xac\xef\xbf\xbd", output_mock_get_string());
+}
+
+TEST(spe_printf, snprintfWideStringLong)
+{
+    wchar_t wide[100];
+    char string[64];
+    int i;
+
+    for (i = 0; i < 99; i++) {
+        wide[i] = 0x20ac;
+    }
+    wide[99] = 0;
+    LONGS_EQUAL(64, spe_snprintf(string, sizeof(string), "%ls", wide));
+    LONGS_EQUAL(63, strlen(string));
+    STRCMP_EQUAL("\xe2\x82\xac", &string[60]);
+}
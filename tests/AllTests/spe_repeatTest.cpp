@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_repeat.h"
+}
+
+static char out[256];
+static size_t out_len;
+static unsigned long clock_now;
+
+static void
+out_putc(char c)
+{
+    if (out_len < sizeof(out) - 1) {
+        out[out_len++] = c;
+    }
+}
+
+static unsigned long
+fake_now(void)
+{
+    return clock_now;
+}
+
+static SPE_FILE out_fd = SPE_PRINTF_SETUP(out_putc);
+static struct spe_repeat_entry recent[8];
+static struct spe_repeat rep = SPE_REPEAT_SETUP(&out_fd, recent, 1000,
+                                                fake_now);
+
+static unsigned long
+fingerprint(const char *fmt, ...)
+{
+    va_list ap;
+    unsigned long returned;
+
+    va_start(ap, fmt);
+    returned = spe_vfingerprint(fmt, ap);
+    va_end(ap);
+
+    return returned;
+}
+
+TEST_GROUP(spe_repeat)
+{
+    void setup() {
+        memset(out, 0, sizeof(out));
+        out_len = 0;
+        clock_now = 0;
+        memset(recent, 0, sizeof(recent));
+    }
+};
+
+TEST(spe_repeat, RepeatsCounted)
+{
+    LONGS_EQUAL(1, spe_repeat_printf(&rep, "ADC %d\n", 3));
+    clock_now = 10;
+    LONGS_EQUAL(0, spe_repeat_printf(&rep, "ADC %d\n", 3));
+    clock_now = 999;
+    LONGS_EQUAL(0, spe_repeat_printf(&rep, "ADC %d\n", 3));
+    STRCMP_EQUAL("ADC 3\n", out);
+}
+
+TEST(spe_repeat, OtherArgumentsPrinted)
+{
+    LONGS_EQUAL(1, spe_repeat_printf(&rep, "ADC %d\n", 3));
+    LONGS_EQUAL(1, spe_repeat_printf(&rep, "ADC %d\n", 4));
+    STRCMP_EQUAL("ADC 3\nADC 4\n", out);
+}
+
+TEST(spe_repeat, SummaryAfterWindow)
+{
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        spe_repeat_printf(&rep, "ADC %d\n", 3);
+    }
+    clock_now = 1000;
+    LONGS_EQUAL(1, spe_repeat_printf(&rep, "ADC %d\n", 3));
+    STRCMP_EQUAL("ADC 3\nrepeated 4 times: ADC 3\nADC 3\n", out);
+}
+
+TEST(spe_repeat, FlushAfterStorm)
+{
+    spe_repeat_printf(&rep, "ADC %d\n", 3);
+    spe_repeat_printf(&rep, "ADC %d\n", 3);
+    LONGS_EQUAL(0, spe_repeat_flush(&rep));
+    clock_now = 2000;
+    LONGS_EQUAL(1, spe_repeat_flush(&rep));
+    LONGS_EQUAL(1, spe_repeat_printf(&rep, "ADC %d\n", 3));
+    STRCMP_EQUAL("ADC 3\nrepeated 1 times: ADC 3\nADC 3\n", out);
+}
+
+/* With a single entry every other line takes it */
+TEST(spe_repeat, SummaryWhenEntryTaken)
+{
+    struct spe_repeat_entry one[1];
+    struct spe_repeat small = SPE_REPEAT_SETUP(&out_fd, one, 1000, fake_now);
+
+    memset(one, 0, sizeof(one));
+    spe_repeat_printf(&small, "ADC %d\n", 3);
+    spe_repeat_printf(&small, "ADC %d\n", 3);
+    spe_repeat_printf(&small, "ADC %d\n", 3);
+    LONGS_EQUAL(1, spe_repeat_printf(&small, "bus off\n"));
+    STRCMP_EQUAL("ADC 3\nrepeated 2 times: ADC 3\nbus off\n", out);
+}
+
+/* A line longer than the entry is printed in full, summarised cut short */
+TEST(spe_repeat, SummaryOfLongLine)
+{
+    char text[SPE_REPEAT_LINE + 8];
+    char expected[3 * SPE_REPEAT_LINE];
+
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    spe_repeat_printf(&rep, "%s\n", text);
+    spe_repeat_printf(&rep, "%s\n", text);
+    clock_now = 1000;
+    spe_repeat_flush(&rep);
+    snprintf(expected, sizeof(expected), "%s\nrepeated 1 times: %.*s\n",
+             text, SPE_REPEAT_LINE - 1, text);
+    STRCMP_EQUAL(expected, out);
+}
+
+/* Without a newline of its own the summary still ends the line */
+TEST(spe_repeat, SummaryWithoutNewline)
+{
+    spe_repeat_printf(&rep, "tick %d", 1);
+    spe_repeat_printf(&rep, "tick %d", 1);
+    clock_now = 1000;
+    spe_repeat_flush(&rep);
+    STRCMP_EQUAL("tick 1repeated 1 times: tick 1\n", out);
+}
+
+TEST(spe_repeat, StringsByContent)
+{
+    char a[] = "radio";
+    char b[] = "radio";
+
+    LONGS_EQUAL(1, spe_repeat_printf(&rep, "%s down\n", a));
+    LONGS_EQUAL(0, spe_repeat_printf(&rep, "%s down\n", b));
+    a[0] = 'R';
+    LONGS_EQUAL(1, spe_repeat_printf(&rep, "%s down\n", a));
+}
+
+TEST(spe_repeat, FingerprintIgnoresTimestamps)
+{
+    unsigned long long t1 = 1000000ULL;
+    unsigned long long t2 = 2000000ULL;
+
+    CHECK(fingerprint("%pTu %d\n", &t1, 5) == fingerprint("%pTu %d\n", &t2, 5));
+    CHECK(fingerprint("%pTu %d\n", &t1, 5) != fingerprint("%pTu %d\n", &t1, 6));
+}
+
+TEST(spe_repeat, FingerprintOfArguments)
+{
+    const unsigned char blob1[] = { 1, 2, 3 };
+    const unsigned char blob2[] = { 1, 2, 4 };
+    static const char fmt[] = "%lu %*pB %5.1f %c";
+
+    CHECK(fingerprint(fmt, 7UL, 3, blob1, 1.5, 'x') ==
+          fingerprint(fmt, 7UL, 3, blob1, 1.5, 'x'));
+    CHECK(fingerprint(fmt, 7UL, 3, blob1, 1.5, 'x') !=
+          fingerprint(fmt, 7UL, 3, blob2, 1.5, 'x'));
+    CHECK(fingerprint(fmt, 7UL, 3, blob1, 1.5, 'x') !=
+          fingerprint(fmt, 7UL, 3, blob1, 2.5, 'x'));
+    CHECK(fingerprint(fmt, 7UL, 3, blob1, 1.5, 'x') !=
+          fingerprint("%lu %*pB %5.1f %c\n", 7UL, 3, blob1, 1.5, 'x'));
+}
+
+TEST(spe_repeat, FingerprintOfBigint)
+{
+    struct spe_u128 counter = { 1ULL, 0ULL };
+    const unsigned long first = fingerprint("%pW %pWd\n", &counter, &counter);
+
+    counter.hi = 1ULL;
+    CHECK(first != fingerprint("%pW %pWd\n", &counter, &counter));
+    counter.hi = 0ULL;
+    CHECK(first == fingerprint("%pW %pWd\n", &counter, &counter));
+}
+
+TEST(spe_repeat, FingerprintOfWideString)
+{
+    wchar_t text[] = L"radio";
+    const unsigned long first = fingerprint("%ls down\n", text);
+
+    text[0] = L'R';
+    CHECK(first != fingerprint("%ls down\n", text));
+    CHECK(fingerprint("%.1ls\n", text) == fingerprint("%.1ls\n", L"Rx"));
+    text[0] = L'r';
+    CHECK(first == fingerprint("%ls down\n", text));
+}
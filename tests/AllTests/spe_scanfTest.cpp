@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_scanf.h"
+}
+
+TEST_GROUP(spe_scanf)
+{
+};
+
+static void
+compare_strtol(const char *s, int base)
+{
+    char *end, *ref_end;
+    long value, ref_value;
+    int err, ref_err;
+
+    errno = 0;
+    value = spe_strtol(s, &end, base);
+    err = errno;
+    errno = 0;
+    ref_value = strtol(s, &ref_end, base);
+    ref_err = errno;
+    LONGS_EQUAL(ref_value, value);
+    LONGS_EQUAL(ref_end - s, end - s);
+    LONGS_EQUAL(ref_err, err);
+}
+
+static void
+compare_strtoul(const char *s, int base)
+{
+    char *end, *ref_end;
+    unsigned long value, ref_value;
+
+    value = spe_strtoul(s, &end, base);
+    ref_value = strtoul(s, &ref_end, base);
+    UNSIGNED_LONGS_EQUAL(ref_value, value);
+    LONGS_EQUAL(ref_end - s, end - s);
+}
+
+TEST(spe_scanf, strtolDecimal)
+{
+    compare_strtol("0", 10);
+    compare_strtol("  -42abc", 10);
+    compare_strtol("+12345678", 10);
+    compare_strtol("123456789012345678", 10);
+    compare_strtol("9223372036854775807", 10);
+    compare_strtol("-9223372036854775808", 10);
+    compare_strtol("9223372036854775808", 10);
+    compare_strtol("-92233720368547758090", 10);
+    compare_strtol("1234567a", 10);
+    compare_strtol("-", 10);
+    compare_strtol("x", 10);
+}
+
+TEST(spe_scanf, strtolBases)
+{
+    compare_strtol("0x1f", 0);
+    compare_strtol("0x", 16);
+    compare_strtol("0755", 0);
+    compare_strtol("zz", 36);
+    compare_strtol("-deadBEEF", 16);
+    compare_strtol("0x0123456789abcdefG", 16);
+    compare_strtol("7fffffffffffffff", 16);
+    compare_strtol("123456789abcdef01", 16);
+    compare_strtol("11111111", 2);
+}
+
+TEST(spe_scanf, strtoul)
+{
+    compare_strtoul("18446744073709551615", 10);
+    compare_strtoul("18446744073709551616", 10);
+    compare_strtoul("-1", 10);
+    compare_strtoul("ffffffffffffffff", 16);
+    compare_strtoul("1ffffffffffffffff", 16);
+    compare_strtoul("12345678901234567890123", 10);
+}
+
+TEST(spe_scanf, strtolBinaryPrefix)
+{
+    char *end;
+    LONGS_EQUAL(5, spe_strtol("0b101x", &end, 0));
+    STRCMP_EQUAL("x", end);
+    LONGS_EQUAL(0, spe_strtol("0b2", &end, 2));
+    STRCMP_EQUAL("b2", end);
+}
+
+static void
+compare_strtod(const char *s)
+{
+    char *end, *ref_end;
+    double value = spe_strtod(s, &end);
+    double ref_value = strtod(s, &ref_end);
+
+    /* Exact, not within a tolerance */
+    CHECK(memcmp(&value, &ref_value, sizeof(value)) == 0);
+    LONGS_EQUAL(ref_end - s, end - s);
+}
+
+TEST(spe_scanf, strtodExact)
+{
+    compare_strtod("0");
+    compare_strtod("-0.0");
+    compare_strtod("3.14159");
+    compare_strtod("  -2.5e3x");
+    compare_strtod("1e22");
+    compare_strtod("123456789.123456");
+    compare_strtod("0.000123456789012345");
+    compare_strtod(".5");
+    compare_strtod("5.");
+    compare_strtod("1e");
+    compare_strtod("1e+");
+    compare_strtod("2E-3");
+    compare_strtod(".");
+    compare_strtod("-");
+    compare_strtod("9007199254740992");
+    compare_strtod("0.1");
+    compare_strtod("1234567890123456.7e-10");
+}
+
+TEST(spe_scanf, strtodLimits)
+{
+    char buf[32];
+
+    compare_strtod("1.7976931348623157e308");
+    compare_strtod("1.7976931348623158e308");
+    compare_strtod("1.7976931348623159e308");
+    compare_strtod("2.2250738585072014e-308");
+    compare_strtod("2.2250738585072011e-308");
+    compare_strtod("2e-308");
+    compare_strtod("4.9406564584124654e-324");
+    compare_strtod("2.4703282292062327e-324");
+    compare_strtod("2.4703282292062328e-324");
+    compare_strtod("1e-343");
+    compare_strtod("1e23");
+    compare_strtod("9007199254740993");
+    compare_strtod("9007199254740995");
+    compare_strtod("45035996273704985e-1");
+    snprintf(buf, sizeof(buf), "%.17g", DBL_MAX);
+    compare_strtod(buf);
+    snprintf(buf, sizeof(buf), "%.17g", DBL_MIN);
+    compare_strtod(buf);
+    snprintf(buf, sizeof(buf), "%.17g", -DBL_MAX);
+    compare_strtod(buf);
+}
+
+/* Round trip of random doubles, the same as libc bit for bit */
+TEST(spe_scanf, strtodRandom)
+{
+    uint64_t state = 88172645463325252ULL;
+    char buf[32];
+    double d;
+    int i;
+
+    for (i = 0; i < 100000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        memcpy(&d, &state, sizeof(d));
+        if ((d - d) != 0.0) {
+            continue;
+        }
+        snprintf(buf, sizeof(buf), "%.17g", d);
+        compare_strtod(buf);
+        snprintf(buf, sizeof(buf), "%llue%d",
+                 (unsigned long long)(state % 10000000000000000000ULL),
+                 (int)((state >> 32) % 700U) - 360);
+        compare_strtod(buf);
+    }
+}
+
+TEST(spe_scanf, strtodLarge)
+{
+    char *end;
+    DOUBLES_EQUAL(1e300, spe_strtod("1e300", &end), 1e285);
+    DOUBLES_EQUAL(1.5e-300, spe_strtod("1.5e-300", &end), 1e-315);
+    DOUBLES_EQUAL(12345678901234567890.0,
+                  spe_strtod("12345678901234567890123e-3", &end), 1e5);
+    errno = 0;
+    spe_strtod("1e999", &end);
+    LONGS_EQUAL(ERANGE, errno);
+}
+
+TEST(spe_scanf, sscanfIntegers)
+{
+    int d;
+    unsigned int u, x, o, b;
+    long ld;
+    unsigned long lx;
+
+    LONGS_EQUAL(7, spe_sscanf("-12 34 0xbeef 17 101 -1234567890123 ff",
+                              "%d %u %x %o %b %ld %lx",
+                              &d, &u, &x, &o, &b, &ld, &lx));
+    LONGS_EQUAL(-12, d);
+    UNSIGNED_LONGS_EQUAL(34, u);
+    UNSIGNED_LONGS_EQUAL(0xbeef, x);
+    UNSIGNED_LONGS_EQUAL(017, o);
+    UNSIGNED_LONGS_EQUAL(5, b);
+    LONGS_EQUAL(-1234567890123L, ld);
+    UNSIGNED_LONGS_EQUAL(0xff, lx);
+}
+
+TEST(spe_scanf, sscanfWidthAndLiterals)
+{
+    int h, m, s;
+
+    LONGS_EQUAL(3, spe_sscanf("T=123456", "T=%2d%2d%2d", &h, &m, &s));
+    LONGS_EQUAL(12, h);
+    LONGS_EQUAL(34, m);
+    LONGS_EQUAL(56, s);
+}
+
+TEST(spe_scanf, sscanfStringsAndChars)
+{
+    char name[8], c[3] = { 0, 0, 0 };
+    int value;
+
+    LONGS_EQUAL(3, spe_sscanf("  setup speed =12", "%3s%*s %*s%2c%d",
+                              name, c, &value));
+    STRCMP_EQUAL("set", name);
+    STRCMP_EQUAL(" =", c);
+    LONGS_EQUAL(12, value);
+}
+
+TEST(spe_scanf, sscanfFloat)
+{
+    float f;
+    double d;
+
+    LONGS_EQUAL(2, spe_sscanf("1.5,-2.25e2", "%f,%lf", &f, &d));
+    DOUBLES_EQUAL(1.5, f, 0.0);
+    DOUBLES_EQUAL(-225.0, d, 0.0);
+}
+
+TEST(spe_scanf, sscanfPointer)
+{
+    void *p;
+
+    LONGS_EQUAL(1, spe_sscanf("0x1234", "%p", &p));
+    POINTERS_EQUAL((void *)0x1234, p);
+    LONGS_EQUAL(1, spe_sscanf("(nil)", "%p", &p));
+    POINTERS_EQUAL(NULL, p);
+}
+
+TEST(spe_scanf, sscanfMismatchAndEnd)
+{
+    int a = 0, b = 0;
+    const char *fmt = "%d %y";
+
+    LONGS_EQUAL(1, spe_sscanf("1 x", "%d %d", &a, &b));
+    LONGS_EQUAL(1, a);
+    LONGS_EQUAL(-1, spe_sscanf("   ", "%d", &a));
+    LONGS_EQUAL(1, spe_sscanf("5", "%d %d", &a, &b));
+    LONGS_EQUAL(0, spe_sscanf("a5", "b%d", &a));
+    LONGS_EQUAL(1, spe_sscanf("50%", "%d%%", &a));
+    LONGS_EQUAL(-1, spe_sscanf("1 2", fmt, &a, &b));
+}
+
+/* Only a single l, as on the output side, so no long long is written */
+TEST(spe_scanf, sscanfLengthModifier)
+{
+    long long ll = 0;
+    long l = 0;
+    wchar_t ws[4];
+
+    LONGS_EQUAL(-1, spe_sscanf("12", "%lld", &ll));
+    LONGS_EQUAL(-1, spe_sscanf("12", "%llu", (unsigned long long *)&ll));
+    LONGS_EQUAL(0, ll);
+    LONGS_EQUAL(-1, spe_sscanf("ab", "%ls", ws));
+    LONGS_EQUAL(1, spe_sscanf("-12", "%li", &l));
+    LONGS_EQUAL(-12, l);
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <syslog.h>
+#include <unistd.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_syslog.h"
+}
+
+/* The receiving end stands in for the collector */
+static int collector;
+static char got[SPE_SYSLOG_LINE + 1];
+static struct spe_syslog_record pending[4];
+static struct spe_syslog sl = SPE_SYSLOG_SETUP(pending, LOG_USER,
+                                               SPE_SYSLOG_RFC3164, "app");
+
+/* Next datagram, or NULL if there is none */
+static const char *
+receive(void)
+{
+    const ssize_t len = recv(collector, got, sizeof(got) - 1, MSG_DONTWAIT);
+
+    if (len < 0) {
+        return NULL;
+    }
+    got[len] = '\0';
+    return got;
+}
+
+static unsigned long long
+fake_now(void)
+{
+    return 1700000000000345ULL;
+}
+
+TEST_GROUP(spe_syslog)
+{
+    void setup() {
+        int pair[2];
+
+        CHECK(!socketpair(AF_UNIX, SOCK_DGRAM, 0, pair));
+        sl.sock = pair[0];
+        sl.head = 0;
+        sl.count = 0;
+        sl.format = SPE_SYSLOG_RFC3164;
+        sl.app = "app";
+        sl.hostname = NULL;
+        sl.pid = 42;
+        sl.now = NULL;
+        collector = pair[1];
+    }
+    void teardown() {
+        spe_syslog_close(&sl);
+        close(collector);
+    }
+};
+
+TEST(spe_syslog, Rfc3164)
+{
+    LONGS_EQUAL(0, spe_syslog_printf(&sl, LOG_ERR, "disk %d%% full\n", 97));
+    LONGS_EQUAL(1, spe_syslog_flush(&sl));
+    STRCMP_EQUAL("<11>app[42]: disk 97% full", receive());
+    POINTERS_EQUAL(NULL, receive());
+}
+
+TEST(spe_syslog, Rfc3164WithoutPid)
+{
+    sl.pid = 0;
+    spe_syslog_printf(&sl, LOG_DEBUG, "x");
+    spe_syslog_flush(&sl);
+    STRCMP_EQUAL("<15>app: x", receive());
+}
+
+TEST(spe_syslog, Rfc5424)
+{
+    sl.format = SPE_SYSLOG_RFC5424;
+    sl.hostname = "gw1";
+    spe_syslog_printf(&sl, LOG_NOTICE, "up");
+    sl.now = fake_now;
+    sl.app = NULL;
+    sl.pid = 0;
+    spe_syslog_printf(&sl, LOG_NOTICE, "up");
+    LONGS_EQUAL(2, spe_syslog_flush(&sl));
+    STRCMP_EQUAL("<13>1 - gw1 app 42 - - up", receive());
+    STRCMP_EQUAL("<13>1 2023-11-14T22:13:20.000345Z gw1 - - - - up",
+                 receive());
+}
+
+TEST(spe_syslog, BatchedUntilFlush)
+{
+    spe_syslog_printf(&sl, LOG_INFO, "one");
+    spe_syslog_printf(&sl, LOG_INFO, "two");
+    spe_syslog_printf(&sl, LOG_INFO, "three");
+    POINTERS_EQUAL(NULL, receive());
+    LONGS_EQUAL(3, spe_syslog_flush(&sl));
+    STRCMP_EQUAL("<14>app[42]: one", receive());
+    STRCMP_EQUAL("<14>app[42]: two", receive());
+    STRCMP_EQUAL("<14>app[42]: three", receive());
+    LONGS_EQUAL(0, spe_syslog_flush(&sl));
+}
+
+TEST(spe_syslog, SentWhenRingFull)
+{
+    int i;
+
+    for (i = 0; i < 6; i++) {
+        LONGS_EQUAL(0, spe_syslog_printf(&sl, LOG_INFO, "%d", i));
+    }
+    for (i = 0; i < 4; i++) {
+        CHECK(receive() != NULL);
+    }
+    POINTERS_EQUAL(NULL, receive());
+    LONGS_EQUAL(2, spe_syslog_flush(&sl));
+    STRCMP_EQUAL("<14>app[42]: 4", receive());
+    STRCMP_EQUAL("<14>app[42]: 5", receive());
+}
+
+/* Records stay in the ring while the collector can't take them */
+TEST(spe_syslog, KeptWhileUnsent)
+{
+    int i;
+
+    close(collector);
+    collector = -1;
+    for (i = 0; i < 4; i++) {
+        LONGS_EQUAL(0, spe_syslog_printf(&sl, LOG_INFO, "%d", i));
+    }
+    LONGS_EQUAL(-1, spe_syslog_printf(&sl, LOG_INFO, "lost"));
+    LONGS_EQUAL(-1, spe_syslog_flush(&sl));
+    LONGS_EQUAL(4, sl.count);
+}
+
+TEST(spe_syslog, Truncated)
+{
+    char text[2 * SPE_SYSLOG_LINE];
+
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    spe_syslog_printf(&sl, LOG_INFO, "%s", text);
+    spe_syslog_flush(&sl);
+    LONGS_EQUAL(SPE_SYSLOG_LINE - 1, strlen(receive()));
+}
+
+TEST(spe_syslog, UdpLoopback)
+{
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    struct spe_syslog_record udp_pending[2];
+    struct spe_syslog udp = SPE_SYSLOG_SETUP(udp_pending, LOG_LOCAL0,
+                                             SPE_SYSLOG_RFC3164, "gw");
+
+    close(collector);
+    collector = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CHECK(!bind(collector, (struct sockaddr *)&addr, sizeof(addr)));
+    CHECK(!getsockname(collector, (struct sockaddr *)&addr, &addr_len));
+
+    LONGS_EQUAL(0, spe_syslog_connect(&udp, (struct sockaddr *)&addr,
+                                      addr_len));
+    CHECK(udp.pid != 0);
+    udp.pid = 7;
+    spe_syslog_printf(&udp, LOG_WARNING, "link down");
+    LONGS_EQUAL(1, spe_syslog_flush(&udp));
+    spe_syslog_close(&udp);
+    STRCMP_EQUAL("<132>gw[7]: link down", receive());
+}
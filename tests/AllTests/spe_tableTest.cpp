@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_table.h"
+}
+
+static char out[512];
+static size_t out_len;
+
+static void
+out_putc(char c)
+{
+    if (out_len < sizeof(out) - 1) {
+        out[out_len++] = c;
+    }
+}
+
+static SPE_FILE out_fd = SPE_PRINTF_SETUP(out_putc);
+
+TEST_GROUP(spe_table)
+{
+    void setup() {
+        memset(out, 0, sizeof(out));
+        out_len = 0;
+    }
+};
+
+TEST(spe_table, WidthsFromContents)
+{
+    struct spe_table_column columns[] = {
+        { "task", 's', 1, 0 },
+        { "stack", 'u', 0, 0 },
+        { "flags", 'x', 0, 0 },
+    };
+    struct spe_table table = SPE_TABLE_SETUP(columns, "  ");
+    const struct spe_arg cells[] = {
+        SPE_ARG_STRING("idle"), SPE_ARG_UINT(128), SPE_ARG_UINT(0x3),
+        SPE_ARG_STRING("radio_rx"), SPE_ARG_UINT(1024),
+        SPE_ARG_UINT(0x1234567),
+    };
+
+    LONGS_EQUAL(0, spe_table_measure(&table, cells, 2));
+    LONGS_EQUAL(8, columns[0].width);
+    LONGS_EQUAL(5, columns[1].width);
+    LONGS_EQUAL(7, columns[2].width);
+    LONGS_EQUAL(0, spe_table_header(&out_fd, &table));
+    LONGS_EQUAL(0, spe_table_rows(&out_fd, &table, cells, 2));
+    STRCMP_EQUAL("task      stack    flags\n"
+                 "--------  -----  -------\n"
+                 "idle        128        3\n"
+                 "radio_rx   1024  1234567\n", out);
+}
+
+/* Padding longer than one run, left aligned last column without trailing */
+TEST(spe_table, LongNumbersAndLeftLast)
+{
+    struct spe_table_column columns[] = {
+        { "n", 'd', 0, 0 },
+        { "b", 'b', 0, 0 },
+        { "name", 's', 1, 0 },
+    };
+    struct spe_table table = SPE_TABLE_SETUP(columns, "|");
+    const struct spe_arg cells[] = {
+        SPE_ARG_LONG(LONG_MIN), SPE_ARG_UINT(5), SPE_ARG_STRING("a"),
+        SPE_ARG_LONG(-7), SPE_ARG_UINT(0xffffffffU), SPE_ARG_STRING(NULL),
+    };
+    char expected[512];
+
+    LONGS_EQUAL(0, spe_table_measure(&table, cells, 2));
+    LONGS_EQUAL(snprintf(NULL, 0, "%ld", LONG_MIN), columns[0].width);
+    LONGS_EQUAL(32, columns[1].width);
+    LONGS_EQUAL(4, columns[2].width);
+    LONGS_EQUAL(0, spe_table_rows(&out_fd, &table, cells, 2));
+    snprintf(expected, sizeof(expected), "%ld|%32s|a\n%*s|%32s|\n",
+             LONG_MIN, "101", columns[0].width, "-7",
+             "11111111111111111111111111111111");
+    STRCMP_EQUAL(expected, out);
+}
+
+TEST(spe_table, MeasuringGrows)
+{
+    struct spe_table_column columns[] = {
+        { "c", 'c', 0, 0 },
+        { "o", 'o', 0, 0 },
+    };
+    struct spe_table table = SPE_TABLE_SETUP(columns, " ");
+    const struct spe_arg first[] = { SPE_ARG_INT('x'), SPE_ARG_UINT(8) };
+    const struct spe_arg second[] = { SPE_ARG_INT('y'), SPE_ARG_UINT(0) };
+
+    LONGS_EQUAL(0, spe_table_measure(&table, first, 1));
+    LONGS_EQUAL(0, spe_table_measure(&table, second, 1));
+    LONGS_EQUAL(2, columns[1].width);
+    LONGS_EQUAL(0, spe_table_rows(&out_fd, &table, first, 1));
+    LONGS_EQUAL(0, spe_table_rows(&out_fd, &table, second, 1));
+    STRCMP_EQUAL("x 10\ny  0\n", out);
+}
+
+TEST(spe_table, WrongTypeFails)
+{
+    struct spe_table_column columns[] = {
+        { "n", 'd', 0, 0 },
+    };
+    struct spe_table table = SPE_TABLE_SETUP(columns, " ");
+    const struct spe_arg cells[] = { SPE_ARG_STRING("x") };
+
+    LONGS_EQUAL(-1, spe_table_measure(&table, cells, 1));
+    LONGS_EQUAL(-1, spe_table_rows(&out_fd, &table, cells, 1));
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include "CppUTest/TestHarness.h"
+
+extern "C" {
+#include "spe_tee.h"
+}
+
+static char uart_out[64];
+static size_t uart_len;
+static char log_out[64];
+static size_t log_len;
+
+static void
+uart_putc(char c)
+{
+    if (uart_len < sizeof(uart_out) - 1) {
+        uart_out[uart_len++] = c;
+    }
+}
+
+static void
+log_putc(char c)
+{
+    if (log_len < sizeof(log_out) - 1) {
+        log_out[log_len++] = c;
+    }
+}
+
+static SPE_FILE uart = SPE_PRINTF_SETUP(uart_putc);
+static SPE_FILE crash_log = SPE_PRINTF_SETUP(log_putc);
+
+static char tee_buf[16];
+static const struct spe_tee_sink tee_sinks[] = {
+    { &uart, 0xffU },
+    { &crash_log, 0xf0U },
+};
+static struct spe_tee tee = SPE_TEE_SETUP(tee_buf, tee_sinks);
+
+TEST_GROUP(spe_tee)
+{
+    void setup() {
+        memset(uart_out, 0, sizeof(uart_out));
+        memset(log_out, 0, sizeof(log_out));
+        uart_len = 0;
+        log_len = 0;
+    }
+};
+
+TEST(spe_tee, AllSinks)
+{
+    LONGS_EQUAL(0, spe_tee_printf(&tee, 0x10U, "T=%d.", -12));
+    STRCMP_EQUAL("T=-12.", uart_out);
+    STRCMP_EQUAL("T=-12.", log_out);
+}
+
+TEST(spe_tee, SeverityMask)
+{
+    LONGS_EQUAL(0, spe_tee_printf(&tee, 0x01U, "debug %u", 1u));
+    LONGS_EQUAL(0, spe_tee_printf(&tee, 0x20U, " err"));
+    STRCMP_EQUAL("debug 1 err", uart_out);
+    STRCMP_EQUAL(" err", log_out);
+}
+
+TEST(spe_tee, NoSinkWantsIt)
+{
+    LONGS_EQUAL(0, spe_tee_printf(&tee, 0x100U, "%s", "dropped"));
+    LONGS_EQUAL(0, uart_len);
+    LONGS_EQUAL(0, log_len);
+}
+
+TEST(spe_tee, TruncatedToStagingBuffer)
+{
+    LONGS_EQUAL(0, spe_tee_printf(&tee, 0x80U, "%s", "0123456789abcdefgh"));
+    STRCMP_EQUAL("0123456789abcde", uart_out);
+    STRCMP_EQUAL("0123456789abcde", log_out);
+}
+
+/* The formatted length is delivered, a \0 from %c does not end the line */
+TEST(spe_tee, NulCharacterDelivered)
+{
+    LONGS_EQUAL(0, spe_tee_printf(&tee, 0x80U, "a%cb%d", 0, 7));
+    LONGS_EQUAL(4, uart_len);
+    LONGS_EQUAL(4, log_len);
+    MEMCMP_EQUAL("a\0b7", uart_out, 4);
+    MEMCMP_EQUAL("a\0b7", log_out, 4);
+}
+
+/* The tee keeps the %pT cache between lines, so a line in the same hour
+ * finds the date and hour already rendered */
+static char stamp_buf[32];
+static struct spe_tee stamp_tee = SPE_TEE_SETUP(stamp_buf, tee_sinks);
+
+TEST(spe_tee, TimestampCacheKept)
+{
+    const unsigned long long t1 = 1700000000ULL; /* 2023-11-14T22:13:20 */
+    const unsigned long long t2 = t1 + 60U;
+    const unsigned long long t3 = t1 + 3600U;
+
+    LONGS_EQUAL(0, spe_tee_printf(&stamp_tee, 0x01U, "%pTs", &t1));
+    UNSIGNED_LONGS_EQUAL(t1 / 3600U + 1U, stamp_tee.tcache.hour);
+    MEMCMP_EQUAL("2023-11-14T22:", stamp_tee.tcache.prefix, 14);
+    memset(stamp_tee.tcache.prefix, '#', 11);
+    LONGS_EQUAL(0, spe_tee_printf(&stamp_tee, 0x01U, " %pTs", &t2));
+    LONGS_EQUAL(0, spe_tee_printf(&stamp_tee, 0x01U, " %pTs", &t3));
+    UNSIGNED_LONGS_EQUAL(t3 / 3600U + 1U, stamp_tee.tcache.hour);
+    STRCMP_EQUAL("2023-11-14T22:13:20Z ###########22:14:20Z "
+                 "2023-11-14T23:13:20Z", uart_out);
+}
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file
+ *
+ * Cycle count per conversion.
+ *
+ * Every conversion is measured with the argument giving the longest output,
+ * one spe_fprintf() call at a time to a file descriptor that throws the
+ * characters away. Each case is repeated and the smallest count is kept,
+ * which removes interrupts and cache misses from the host measurement but
+ * keeps the worst case input. The overhead of reading the counter is
+ * measured the same way and subtracted. The input functions of
+ * spe_scanf.c are measured the same way, with their longest input, and so
+ * is an array of eight values through spe_column.c, a repeated line
+ * suppressed by spe_repeat.c and a row of a table through spe_table.c.
+ *
+ * A case may name another one it must beat, such as the array through
+ * spe_column.c against the same values printed by eight spe_fprintf()
+ * calls. With a budget file it fails when it doesn't.
+ *
+ * The counter is the cycle counter of the DWT on Cortex-M3/M4 when built
+ * with -DSPE_BENCH_DWT, the time stamp counter on x86 and nanoseconds
+ * elsewhere.
+ *
+ * With a budget file given, every case must be listed and within its
+ * budget, otherwise the exit status is 1.
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spe_printf.h"
+#include "spe_scanf.h"
+#include "spe_column.h"
+#include "spe_repeat.h"
+#include "spe_table.h"
+
+#if defined(SPE_BENCH_DWT)
+#define DWT_CTRL   (*(volatile unsigned long *)0xE0001000UL)
+#define DWT_CYCCNT (*(volatile unsigned long *)0xE0001004UL)
+#define DEMCR      (*(volatile unsigned long *)0xE000EDFCUL)
+#define COUNTER_UNIT "cycles"
+
+static void
+counter_init(void)
+{
+    DEMCR |= 1UL << 24;  /* TRCENA */
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1UL;     /* CYCCNTENA */
+} /* counter_init */
+
+static unsigned long long
+counter(void)
+{
+    return DWT_CYCCNT;
+} /* counter */
+
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COUNTER_UNIT "TSC ticks"
+
+static void
+counter_init(void)
+{
+} /* counter_init */
+
+static unsigned long long
+counter(void)
+{
+    return __rdtsc();
+} /* counter */
+
+#else
+#include <time.h>
+#define COUNTER_UNIT "ns"
+
+static void
+counter_init(void)
+{
+} /* counter_init */
+
+static unsigned long long
+counter(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL +
+        (unsigned long long)ts.tv_nsec;
+} /* counter */
+#endif
+
+#define REPEATS 2000
+
+static volatile char sink_char;
+
+static void
+sink(char c)
+{
+    sink_char = c;
+} /* sink */
+
+SPE_FILE null_output = SPE_PRINTF_SETUP(sink);
+SPE_FILE *spe_stdout = &null_output;
+
+static const char long_string[] = "0123456789abcdef0123456789abcdef";
+#ifdef USE_TIMESTAMP
+static unsigned long long time_us = 4102444799999999ULL;
+static unsigned long long time_us_next_day = 4102444799999999ULL;
+#endif
+
+/**
+ * One conversion to measure. run() makes a single spe_fprintf() call.
+ */
+struct bench_case {
+    const char *name;
+    void (*run)(void);
+};
+
+#define BENCH(name, ...)                                \
+    static void                                         \
+    bench_##name(void)                                  \
+    {                                                   \
+        spe_fprintf(&null_output, __VA_ARGS__);         \
+    }
+
+BENCH(empty, "%s", "")
+BENCH(percent, "%%")
+BENCH(char, "%c", 'x')
+BENCH(string, "%s", long_string)
+BENCH(int, "%d", INT_MIN)
+BENCH(int_width, "%14.12d", INT_MIN)
+BENCH(uint, "%u", UINT_MAX)
+BENCH(long, "%ld", LONG_MIN)
+BENCH(ulong, "%lu", ULONG_MAX)
+BENCH(hex, "%x", UINT_MAX)
+BENCH(hex_long, "%lX", ULONG_MAX)
+BENCH(octal, "%lo", ULONG_MAX)
+BENCH(binary, "%b", UINT_MAX)
+BENCH(pointer, "%p", (void *)long_string)
+BENCH(zero_pad, "%020lu", ULONG_MAX)
+BENCH(quoted, "%pJ", long_string)
+BENCH(base64, "%*pB", (int)sizeof(long_string) - 1, long_string)
+#ifdef USE_BIGINT
+static const struct spe_u128 u128_max = { ~0ULL, ~0ULL };
+BENCH(u128, "%pW", &u128_max)
+#endif
+#ifdef USE_UTF8
+BENCH(string_prec, "%.30s", long_string)
+#endif
+/* Integers written straight into a string */
+static void
+bench_string_sink(void)
+{
+    static char buf[64];
+
+    spe_snprintf(buf, sizeof(buf), "%d %lu %lx", INT_MIN, ULONG_MAX,
+                 ULONG_MAX);
+}
+/* Text between the conversions and a string, to a string */
+static void
+bench_text_sink(void)
+{
+    static char buf[128];
+
+    spe_snprintf(buf, sizeof(buf), "Temperature sensor %s reading: %d\n",
+                 long_string, INT_MIN);
+}
+/* Only the first few characters fit, the rest should cost next to nothing */
+static void
+bench_truncated(void)
+{
+    static char small[8];
+
+    spe_snprintf(small, sizeof(small), "%s%s%s%lu%lu", long_string,
+                 long_string, long_string, ULONG_MAX, ULONG_MAX);
+}
+#ifdef USE_DOUBLE
+BENCH(double, "%f", -4294967.123456)
+BENCH(double_prec, "%.9f", -4.123456789)
+#endif
+#ifdef USE_TIMESTAMP
+BENCH(timestamp_cached, "%pTu", &time_us)
+/* Alternates between two days to always miss the cache */
+static void
+bench_timestamp_uncached(void)
+{
+    time_us_next_day ^= 4102444799999999ULL ^ 4102531199999999ULL;
+    spe_fprintf(&null_output, "%pTu", &time_us_next_day);
+}
+BENCH(duration, "%pDu", &time_us)
+#endif
+
+/* Eight values of ten digits through spe_column.c, compare with uint */
+static const uint32_t column_values[8] = {
+    4294967295U, 4000000000U, 3999999999U, 1234567890U,
+    4294967295U, 4000000000U, 3999999999U, 1234567890U,
+};
+
+static void
+bench_u32_array(void)
+{
+    spe_fput_u32_array(&null_output, column_values, 8, ",");
+}
+
+/* The same values and separators, one spe_fprintf() per value */
+static void
+bench_u32_fprintf(void)
+{
+    int i;
+
+    for (i = 0; i < 7; i++) {
+        spe_fprintf(&null_output, "%lu,", (unsigned long)column_values[i]);
+    }
+    spe_fprintf(&null_output, "%lu", (unsigned long)column_values[7]);
+}
+
+/* A line suppressed as a repeat, compare with text_sink */
+static unsigned long
+bench_clock(void)
+{
+    return 0;
+}
+
+static struct spe_repeat_entry recent[8];
+static struct spe_repeat repeat_output = SPE_REPEAT_SETUP(&null_output,
+                                                          recent, 1000,
+                                                          bench_clock);
+
+static void
+bench_repeat(void)
+{
+    spe_repeat_printf(&repeat_output, "Temperature sensor %s reading: %d\n",
+                      long_string, INT_MIN);
+}
+
+/* A row of three columns already measured, compare with int and string */
+static struct spe_table_column table_columns[] = {
+    { .title = "task", .conversion = 's', .left = 1, .width = 32 },
+    { .title = "stack", .conversion = 'u', .width = 10 },
+    { .title = "flags", .conversion = 'x', .width = 8 },
+};
+static const struct spe_table table = SPE_TABLE_SETUP(table_columns, "  ");
+static const struct spe_arg table_row[] = {
+    SPE_ARG_STRING(long_string), SPE_ARG_UINT(UINT_MAX), SPE_ARG_UINT(3),
+};
+
+static void
+bench_table_row(void)
+{
+    spe_table_rows(&null_output, &table, table_row, 1);
+}
+
+/* Input side, spe_scanf.c */
+static volatile unsigned long scan_sink;
+
+static void
+bench_strtol(void)
+{
+    scan_sink = (unsigned long)spe_strtol("-9223372036854775808", NULL, 10);
+}
+
+static void
+bench_strtoul_hex(void)
+{
+    scan_sink = spe_strtoul("ffffffffffffffff", NULL, 16);
+}
+
+#ifdef USE_DOUBLE
+static void
+bench_strtod(void)
+{
+    scan_sink = (unsigned long)spe_strtod("-4294967.123456", NULL);
+}
+#endif
+
+static void
+bench_sscanf(void)
+{
+    int d;
+    unsigned long x;
+
+    spe_sscanf("-2147483648 ffffffffffffffff", "%d %lx", &d, &x);
+    scan_sink = x;
+}
+
+static const struct bench_case cases[] = {
+    { "empty", bench_empty },
+    { "percent", bench_percent },
+    { "char", bench_char },
+    { "string", bench_string },
+    { "int", bench_int },
+    { "int_width", bench_int_width },
+    { "uint", bench_uint },
+    { "long", bench_long },
+    { "ulong", bench_ulong },
+    { "hex", bench_hex },
+    { "hex_long", bench_hex_long },
+    { "octal", bench_octal },
+    { "binary", bench_binary },
+    { "pointer", bench_pointer },
+    { "zero_pad", bench_zero_pad },
+    { "quoted", bench_quoted },
+    { "base64", bench_base64 },
+#ifdef USE_BIGINT
+    { "u128", bench_u128 },
+#endif
+#ifdef USE_UTF8
+    { "string_prec", bench_string_prec },
+#endif
+    { "string_sink", bench_string_sink },
+    { "text_sink", bench_text_sink },
+    { "truncated", bench_truncated },
+#ifdef USE_DOUBLE
+    { "double", bench_double },
+    { "double_prec", bench_double_prec },
+#endif
+#ifdef USE_TIMESTAMP
+    { "timestamp_cached", bench_timestamp_cached },
+    { "timestamp_uncached", bench_timestamp_uncached },
+    { "duration", bench_duration },
+#endif
+    { "u32_array", bench_u32_array },
+    { "u32_fprintf", bench_u32_fprintf },
+    { "repeat", bench_repeat },
+    { "table_row", bench_table_row },
+    { "strtol", bench_strtol },
+    { "strtoul_hex", bench_strtoul_hex },
+#ifdef USE_DOUBLE
+    { "strtod", bench_strtod },
+#endif
+    { "sscanf", bench_sscanf },
+};
+
+/**
+ * Cases that must be faster than another one.
+ */
+static const struct {
+    const char *fast;
+    const char *slow;
+} must_beat[] = {
+    { "u32_array", "u32_fprintf" },
+};
+
+/**
+ * Index of the case called name.
+ */
+static size_t
+case_index(const char *name)
+{
+    size_t i;
+
+    for (i = 0; strcmp(cases[i].name, name); i++) {
+    }
+    return i;
+} /* case_index */
+
+static void
+bench_nothing(void)
+{
+} /* bench_nothing */
+
+/**
+ * Smallest count for one call of run().
+ */
+static unsigned long long
+measure(void (*run)(void))
+{
+    unsigned long long best = ~0ULL;
+    int i;
+
+    for (i = 0; i < REPEATS; i++) {
+        unsigned long long start = counter();
+        run();
+        unsigned long long spent = counter() - start;
+        if (spent < best) {
+            best = spent;
+        }
+    }
+    return best;
+} /* measure */
+
+/**
+ * Budget for a case from a file of "name count" lines, -1 if not listed.
+ */
+static long
+budget_for(const char *budget, const char *name)
+{
+    char line[128];
+    long found = -1;
+    FILE *f = fopen(budget, "r");
+
+    if (!f) {
+        perror(budget);
+        exit(2);
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char case_name[64];
+        long count;
+        if ((line[0] != '#') &&
+            (sscanf(line, "%63s %ld", case_name, &count) == 2) &&
+            !strcmp(case_name, name)) {
+            found = count;
+        }
+    }
+    fclose(f);
+    return found;
+} /* budget_for */
+
+int
+main(int argc, char *argv[])
+{
+    const char *budget = (argc > 1) ? argv[1] : NULL;
+    unsigned long long overhead;
+    unsigned long long spent_of[sizeof(cases) / sizeof(cases[0])];
+    size_t i;
+    int failed = 0;
+
+    counter_init();
+    overhead = measure(bench_nothing);
+
+    printf("%-20s %10s %8s\n", "conversion", COUNTER_UNIT, "budget");
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        unsigned long long spent = measure(cases[i].run);
+        long limit = budget ? budget_for(budget, cases[i].name) : -1;
+
+        spent = (spent > overhead) ? spent - overhead : 0;
+        if (limit < 0) {
+            printf("%-20s %10llu %8s", cases[i].name, spent, "-");
+        } else {
+            printf("%-20s %10llu %8ld", cases[i].name, spent, limit);
+        }
+        if (budget && ((limit < 0) || (spent > (unsigned long long)limit))) {
+            printf("  %s", (limit < 0) ? "NO BUDGET" : "OVER BUDGET");
+            failed = 1;
+        }
+        printf("\n");
+        spent_of[i] = spent;
+    }
+    for (i = 0; i < sizeof(must_beat) / sizeof(must_beat[0]); i++) {
+        const unsigned long long fast = spent_of[case_index(must_beat[i].fast)];
+        const unsigned long long slow = spent_of[case_index(must_beat[i].slow)];
+
+        printf("%s is %.1f times faster than %s", must_beat[i].fast,
+               fast ? (double)slow / (double)fast : 0.0, must_beat[i].slow);
+        if (budget && (fast >= slow)) {
+            printf("  NOT FASTER");
+            failed = 1;
+        }
+        printf("\n");
+    }
+    printf("Counter overhead %llu %s subtracted.\n", overhead, COUNTER_UNIT);
+
+    return failed;
+} /* main */
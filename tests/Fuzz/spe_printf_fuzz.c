@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2026 Stefan Petersen, Ciellt AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file
+ *
+ * Differential fuzzer comparing spe_snprintf() with the snprintf() of the
+ * host libc.
+ *
+ * The fuzz input is decoded into a handful of conversions, each with
+ * literal text around it, flags, minimal width, precision, argument and
+ * output buffer size. Only the grammar where spe_printf and libc are
+ * supposed to agree is generated, see gen_conv(). Each conversion is
+ * rendered by both implementations and any difference aborts, printing the
+ * format string and both results.
+ *
+ * Built with -DSPE_FUZZ_LIBFUZZER and -fsanitize=fuzzer it is a libFuzzer
+ * target. Otherwise it has its own main() generating random input, which
+ * also measures the time spent in spe_snprintf() and snprintf() and prints
+ * execs/sec, so performance regressions show up next to correctness
+ * failures.
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "spe_printf.h"
+
+#define MAX_CONVS     8
+#define MAX_FMT       48
+#define MAX_OUTPUT    128
+
+/**
+ * Type of the value argument of a conversion.
+ */
+enum arg_type_t {
+    ARG_INT,
+    ARG_LONG,
+    ARG_DOUBLE,
+    ARG_STRING,
+    ARG_NONE,
+};
+
+/**
+ * One generated conversion with literal text around it.
+ */
+struct conv {
+    char fmt[MAX_FMT];     /* Format string */
+    enum arg_type_t type;  /* Type of value */
+    int nuf_stars;         /* Width and precision given as parameters */
+    int star[2];           /* Those parameters */
+    long l;                /* Value for ARG_INT and ARG_LONG */
+    double d;              /* Value for ARG_DOUBLE */
+    const char *s;         /* Value for ARG_STRING */
+    size_t size;           /* Output buffer size */
+};
+
+/* Not used, but required by the library. */
+SPE_FILE *spe_stdout = NULL;
+
+typedef int (*snprintf_fn)(char *str, size_t size, const char *fmt, ...);
+
+/**
+ * Fuzz input being consumed. Reads past the end returns zeros.
+ */
+struct input {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+};
+
+static unsigned int
+get(struct input *in, unsigned int n)
+{
+    unsigned int b = (in->pos < in->size) ? in->data[in->pos++] : 0U;
+
+    return b % n;
+} /* get */
+
+static unsigned long
+get_bits(struct input *in, int bytes)
+{
+    unsigned long v = 0;
+
+    while (bytes--) {
+        v = (v << 8) | get(in, 256);
+    }
+    return v;
+} /* get_bits */
+
+static const char *const strings[] = {
+    "", "a", "Hello World", "%d", "trailing space ",
+};
+
+static const int interesting_ints[] = {
+    0, 1, -1, 9, 10, -10, 99, 100, 255, 256, 65535, INT_MAX, INT_MIN,
+};
+
+/**
+ * Add literal text to the format string, never a %.
+ */
+static void
+gen_literal(struct input *in, char *fmt, size_t *pos)
+{
+    unsigned int n = get(in, 4);
+
+    while (n--) {
+        char c = (char)(' ' + get(in, 95));
+        fmt[(*pos)++] = (c == '%') ? '_' : c;
+    }
+} /* gen_literal */
+
+/**
+ * Add a decimal number to the format string.
+ */
+static void
+gen_number(char *fmt, size_t *pos, int n)
+{
+    *pos += (size_t)snprintf(&fmt[*pos], MAX_FMT - *pos, "%d", n);
+} /* gen_number */
+
+/**
+ * Decode one conversion from the fuzz input. Known differences to libc
+ * are kept out of the grammar:
+ * \li the -, + and space flags are rejected by spe_printf, and # is
+ *     ignored for some conversions.
+ * \li width and precision are not supported for strings and characters.
+ * \li precision 0 prints a 0 valued integer as "0", libc prints nothing.
+ * \li doubles are truncated rather than rounded, so only values exactly
+ *     representable with the precision given are generated.
+ */
+static void
+gen_conv(struct input *in, struct conv *cv)
+{
+    static const char convs[] = "duxXobdcsf%";
+    const char c = convs[get(in, sizeof(convs) - 1)];
+    int is_long = 0, alt = 0, zero = 0, width = -1, precision = -1;
+    size_t pos = 0;
+
+    memset(cv, 0, sizeof(*cv));
+    gen_literal(in, cv->fmt, &pos);
+    cv->fmt[pos++] = '%';
+
+    switch (c) {
+    case 'd':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'b':
+    case 'f':
+        /* '#' is ignored for octal, see the documentation */
+        alt = (c != 'o') && (c != 'd') && (c != 'u') && (c != 'f') &&
+            (get(in, 4) == 0);
+        zero = (get(in, 4) == 0);
+        width = (int)get(in, 26) - 1;
+        if (c == 'f') {
+            precision = (int)get(in, 11) - 1;
+        } else if (get(in, 2)) {
+            precision = 1 + (int)get(in, 12);
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (alt) {
+        cv->fmt[pos++] = '#';
+    }
+    if (zero) {
+        cv->fmt[pos++] = '0';
+    }
+    if (width >= 0) {
+        if (get(in, 4) == 0) {
+            cv->fmt[pos++] = '*';
+            cv->star[cv->nuf_stars++] = width;
+        } else {
+            gen_number(cv->fmt, &pos, width);
+        }
+    }
+    if (precision >= 0) {
+        cv->fmt[pos++] = '.';
+        if (get(in, 4) == 0) {
+            cv->fmt[pos++] = '*';
+            cv->star[cv->nuf_stars++] = precision;
+        } else {
+            gen_number(cv->fmt, &pos, precision);
+        }
+    }
+
+    switch (c) {
+    case 'd':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'b':
+        is_long = (get(in, 2) != 0);
+        if (is_long) {
+            cv->fmt[pos++] = 'l';
+            cv->type = ARG_LONG;
+            cv->l = (long)get_bits(in, (int)sizeof(long));
+        } else {
+            cv->type = ARG_INT;
+            if (get(in, 2)) {
+                cv->l = interesting_ints[get(in, sizeof(interesting_ints) /
+                                             sizeof(interesting_ints[0]))];
+            } else {
+                cv->l = (int)(unsigned int)get_bits(in, 4);
+            }
+        }
+        break;
+    case 'c':
+        cv->type = ARG_INT;
+        cv->l = ' ' + (long)get(in, 95);
+        break;
+    case 's':
+        cv->type = ARG_STRING;
+        cv->s = strings[get(in, sizeof(strings) / sizeof(strings[0]))];
+        break;
+    case 'f':
+        cv->type = ARG_DOUBLE;
+        cv->d = (double)get_bits(in, 2);
+        /* Eighths are exact with three decimals or more */
+        if ((precision < 0) || (precision >= 3)) {
+            cv->d += (double)get(in, 8) / 8.0;
+        }
+        if ((cv->d != 0.0) && get(in, 2)) {
+            cv->d = -cv->d;
+        }
+        break;
+    default:
+        cv->type = ARG_NONE;
+        break;
+    }
+    cv->fmt[pos++] = c;
+    gen_literal(in, cv->fmt, &pos);
+    cv->fmt[pos] = 0;
+
+    cv->size = 1 + get(in, MAX_OUTPUT);
+} /* gen_conv */
+
+#define RENDER(arg)                                                     \
+    ((cv->nuf_stars == 0) ? fn(buf, cv->size, cv->fmt, arg) :           \
+     (cv->nuf_stars == 1) ? fn(buf, cv->size, cv->fmt, cv->star[0], arg) : \
+     fn(buf, cv->size, cv->fmt, cv->star[0], cv->star[1], arg))
+
+/**
+ * Render one conversion with either snprintf() or spe_snprintf().
+ */
+static int
+render(snprintf_fn fn, const struct conv *cv, char *buf)
+{
+    switch (cv->type) {
+    case ARG_INT:
+        return RENDER((int)cv->l);
+    case ARG_LONG:
+        return RENDER(cv->l);
+    case ARG_DOUBLE:
+        return RENDER(cv->d);
+    case ARG_STRING:
+        return RENDER(cv->s);
+    case ARG_NONE:
+    default:
+        return RENDER(0);
+    }
+} /* render */
+
+static double spe_seconds, libc_seconds;
+
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+} /* now */
+
+/**
+ * Run one fuzz input. Aborts on any difference to libc.
+ */
+static void
+run_one(const uint8_t *data, size_t size)
+{
+    struct input in = { data, size, 0 };
+    struct conv convs[MAX_CONVS];
+    char got[MAX_CONVS][MAX_OUTPUT];
+    char expected[MAX_CONVS][MAX_OUTPUT];
+    int got_ret[MAX_CONVS], expected_ret[MAX_CONVS];
+    int nuf_convs = 1 + (int)get(&in, MAX_CONVS);
+    double t;
+    int i;
+
+    for (i = 0; i < nuf_convs; i++) {
+        gen_conv(&in, &convs[i]);
+    }
+
+    t = now();
+    for (i = 0; i < nuf_convs; i++) {
+        got_ret[i] = render(spe_snprintf, &convs[i], got[i]);
+    }
+    spe_seconds += now() - t;
+
+    t = now();
+    for (i = 0; i < nuf_convs; i++) {
+        expected_ret[i] = render(snprintf, &convs[i], expected[i]);
+    }
+    libc_seconds += now() - t;
+
+    for (i = 0; i < nuf_convs; i++) {
+        /* spe_snprintf() returns the number of characters written,
+           including the terminating \0 */
+        int len = expected_ret[i];
+        if (len > (int)convs[i].size - 1) {
+            len = (int)convs[i].size - 1;
+        }
+        if ((got_ret[i] != len + 1) || strcmp(got[i], expected[i])) {
+            fprintf(stderr, "Mismatch for format \"%s\" (size %zu)\n",
+                    convs[i].fmt, convs[i].size);
+            fprintf(stderr, "  expected %d \"%s\"\n", len + 1, expected[i]);
+            fprintf(stderr, "  got      %d \"%s\"\n", got_ret[i], got[i]);
+            abort();
+        }
+    }
+} /* run_one */
+
+#ifdef SPE_FUZZ_LIBFUZZER
+int
+LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    run_one(data, size);
+    return 0;
+} /* LLVMFuzzerTestOneInput */
+
+#else
+
+/**
+ * Replay a crash or corpus file.
+ */
+static int
+replay(const char *name)
+{
+    uint8_t data[4096];
+    size_t size;
+    FILE *f = fopen(name, "rb");
+
+    if (!f) {
+        perror(name);
+        return -1;
+    }
+    size = fread(data, 1, sizeof(data), f);
+    fclose(f);
+    run_one(data, size);
+    return 0;
+} /* replay */
+
+static void
+usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-n execs] [-s seed] [-r min execs/sec] [-o csv]"
+            " [file...]\n"
+            "  Without files, runs random input and reports throughput.\n"
+            "  With files, replays them.\n", prog);
+} /* usage */
+
+int
+main(int argc, char *argv[])
+{
+    unsigned long execs = 200000, i;
+    unsigned long seed = 1;
+    double min_rate = 0.0, rate, total;
+    const char *csv = NULL;
+    uint64_t x;
+    int arg;
+
+    for (arg = 1; (arg < argc) && (argv[arg][0] == '-'); arg++) {
+        if (!argv[arg][1] || argv[arg][2] || (arg + 1 >= argc)) {
+            usage(argv[0]);
+            return 2;
+        }
+        switch (argv[arg][1]) {
+        case 'n':
+            execs = strtoul(argv[++arg], NULL, 0);
+            break;
+        case 's':
+            seed = strtoul(argv[++arg], NULL, 0);
+            break;
+        case 'r':
+            min_rate = strtod(argv[++arg], NULL);
+            break;
+        case 'o':
+            csv = argv[++arg];
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (arg < argc) {
+        for (; arg < argc; arg++) {
+            if (replay(argv[arg]) < 0) {
+                return 2;
+            }
+        }
+        printf("Replayed %d file(s), no differences\n", argc - arg);
+        return 0;
+    }
+
+    x = seed ? seed : 1;
+    total = now();
+    for (i = 0; i < execs; i++) {
+        uint8_t data[64];
+        size_t j;
+
+        /* xorshift64 */
+        for (j = 0; j < sizeof(data); j++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            data[j] = (uint8_t)x;
+        }
+        run_one(data, sizeof(data));
+    }
+    total = now() - total;
+
+    rate = (double)execs / total;
+    printf("execs: %lu, seed: %lu, time: %.2f s, execs/sec: %.0f\n",
+           execs, seed, total, rate);
+    printf("spe_snprintf: %.2f s, snprintf: %.2f s, ratio: %.2f\n",
+           spe_seconds, libc_seconds, spe_seconds / libc_seconds);
+
+    if (csv) {
+        FILE *f = fopen(csv, "a");
+        if (f) {
+            fprintf(f, "%ld,%lu,%lu,%.0f,%.4f,%.4f\n", (long)time(NULL),
+                    seed, execs, rate, spe_seconds, libc_seconds);
+            fclose(f);
+        }
+    }
+
+    if (rate < min_rate) {
+        fprintf(stderr, "execs/sec %.0f below required %.0f\n",
+                rate, min_rate);
+        return 1;
+    }
+
+    return 0;
+} /* main */
+#endif /* SPE_FUZZ_LIBFUZZER */
@@ -48,6 +48,6 @@ char *output_mock_get_string(void);
  * output_mock_char_input()
  * Returns the number of characters.
  */
-int output_mock_get_stringlength(void);
+int output_mock_get_string_length(void);
 
 #endif /* OUTPUT_MOCK_H */
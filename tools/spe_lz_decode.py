@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2026 Stefan Petersen, Ciellt AB
+#
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the
+# "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+# IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+# SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+"""Decompress a log written through spe_lz.c.
+
+Reads the raw contents of the storage, for instance a dump of the flash
+area, decodes one block after another and writes the text to stdout. The
+log ends at the first byte that doesn't start a block, which is where
+erased (0xff) or zeroed storage begins. A block that can't be decoded is
+reported on stderr and skipped if its header is sane, the following blocks
+don't depend on it.
+
+See spe_lz.c for the format.
+"""
+
+import argparse
+import sys
+
+HEADER = 5
+MIN_MATCH = 3
+
+
+def decode_block(data):
+    """Return the characters of a compressed block, ValueError if damaged."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        flags = data[i]
+        i += 1
+        for bit in range(8):
+            if i >= len(data):
+                break
+            if flags & (1 << bit):
+                if i + 2 > len(data):
+                    raise ValueError('match cut short')
+                length = (data[i] >> 4) + MIN_MATCH
+                distance = (((data[i] & 0x0f) << 8) | data[i + 1]) + 1
+                i += 2
+                if distance > len(out):
+                    raise ValueError('match before start of block')
+                # Byte by byte, the match may overlap itself
+                for _ in range(length):
+                    out.append(out[-distance])
+            else:
+                out.append(data[i])
+                i += 1
+    return bytes(out)
+
+
+def decode(data, errors):
+    """Yield the characters of each block in data, append problems to
+    errors."""
+    pos = 0
+    while pos + HEADER <= len(data) and data[pos] in b'ZS':
+        kind = data[pos]
+        raw = data[pos + 1] | (data[pos + 2] << 8)
+        end = pos + HEADER + (data[pos + 3] | (data[pos + 4] << 8))
+        if end > len(data):
+            errors.append('block at %d: cut short' % pos)
+            return
+        payload = data[pos + HEADER:end]
+        try:
+            text = payload if kind == ord('S') else decode_block(payload)
+            if len(text) != raw:
+                raise ValueError('%d characters, header says %d'
+                                 % (len(text), raw))
+            yield text
+        except ValueError as e:
+            errors.append('block at %d: %s' % (pos, e))
+        pos = end
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('file', nargs='?', help='storage dump, stdin if none')
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, 'rb') as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    errors = []
+    for text in decode(data, errors):
+        sys.stdout.buffer.write(text)
+    for error in errors:
+        sys.stderr.write(error + '\n')
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2026 Stefan Petersen, Ciellt AB
+#
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the
+# "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+# IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+# SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+"""Worst case stack usage from gcc's -fcallgraph-info=su output.
+
+Reads the .ci files gcc writes next to the object files, adds up the frame
+of each function with the deepest path through its callees and prints one
+line per function. Functions with dynamic frames or recursion have no
+bound and are flagged as such.
+
+Calls through function pointers (the putc callback, custom conversions)
+and calls to functions outside the analysed files are unknown to the call
+graph. They are counted as --indirect and --external bytes respectively,
+both 0 by default, and listed in the report.
+
+With --budget, every function in the budget file must be found, be bounded
+and stay within its budget, otherwise the exit status is 1.
+"""
+
+import argparse
+import re
+import sys
+
+NODE_RE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+SIZE_RE = re.compile(r'\\n(\d+) bytes \(([a-z,]+)\)')
+INDIRECT = '__indirect_call'
+
+
+def parse(files):
+    """Return {title: (name, bytes, qualifier)} and {title: set(callees)}."""
+    nodes, edges = {}, {}
+    for name in files:
+        with open(name) as f:
+            for line in f:
+                m = NODE_RE.search(line)
+                if m:
+                    title, label = m.groups()
+                    size = SIZE_RE.search(label)
+                    func = label.split('\\n')[0]
+                    if size:
+                        nodes[title] = (func, int(size.group(1)),
+                                        size.group(2))
+                    elif title not in nodes:
+                        nodes[title] = (func, None, 'external')
+                    continue
+                m = EDGE_RE.search(line)
+                if m:
+                    edges.setdefault(m.group(1), set()).add(m.group(2))
+    return nodes, edges
+
+
+def worst_case(nodes, edges, indirect, external):
+    """Return {title: (bytes or None, path, notes)}."""
+    result = {}
+    visiting = set()
+
+    def visit(title):
+        if title in result:
+            return result[title]
+        if title in visiting:
+            return (None, [title], {'recursion'})
+        if title == INDIRECT:
+            return (indirect, ['(indirect call)'], {'indirect'})
+        func, size, qualifier = nodes.get(title, (title, None, 'external'))
+        if size is None:
+            return (external, [func], {'external ' + func})
+        visiting.add(title)
+        notes = set()
+        if qualifier != 'static':
+            notes.add(qualifier)
+        deepest, path = 0, []
+        bounded = qualifier == 'static'
+        for callee in sorted(edges.get(title, ())):
+            c_bytes, c_path, c_notes = visit(callee)
+            notes |= c_notes
+            if c_bytes is None:
+                bounded = False
+            elif c_bytes > deepest:
+                deepest, path = c_bytes, c_path
+        visiting.discard(title)
+        result[title] = (size + deepest if bounded else None,
+                         [func] + path, notes)
+        return result[title]
+
+    for title in nodes:
+        visit(title)
+    return result
+
+
+def read_budget(name):
+    budget = {}
+    with open(name) as f:
+        for line in f:
+            line = line.split('#')[0].split()
+            if line:
+                budget[line[0]] = int(line[1])
+    return budget
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('files', nargs='+', help='.ci files from gcc')
+    parser.add_argument('--indirect', type=int, default=0,
+                        help='bytes assumed for calls through pointers')
+    parser.add_argument('--external', type=int, default=0,
+                        help='bytes assumed for calls to other files')
+    parser.add_argument('--budget', help='file with "function bytes" lines')
+    parser.add_argument('--all', action='store_true',
+                        help='also list internal (static) functions')
+    args = parser.parse_args()
+
+    nodes, edges = parse(args.files)
+    result = worst_case(nodes, edges, args.indirect, args.external)
+    budget = read_budget(args.budget) if args.budget else {}
+
+    by_name = {}
+    for title, (func, size, _) in nodes.items():
+        if size is None:
+            continue
+        # Public functions have plain titles, static ones file:name
+        public = ':' not in title
+        name = func.split('.')[0]
+        if public or args.all or name in budget:
+            by_name[name] = (result[title], public)
+
+    failed = False
+    print('%-28s %6s %6s  %s' % ('function', 'worst', 'budget', 'path'))
+    for name in sorted(by_name, key=lambda n: (not by_name[n][1], n)):
+        (size, path, notes), _ = by_name[name]
+        limit = budget.get(name)
+        status = ''
+        if size is None:
+            status = 'UNBOUNDED'
+        elif limit is not None and size > limit:
+            status = 'OVER BUDGET'
+        if status and limit is not None:
+            failed = True
+        print('%-28s %6s %6s  %s%s' % (
+            name, size if size is not None else '-',
+            limit if limit is not None else '-',
+            ' > '.join(p.split('.')[0] for p in path),
+            ('  [' + ', '.join(sorted(notes)) + ']') if notes else ''))
+        if status:
+            print('%-28s %s' % ('', status))
+
+    for name in sorted(set(budget) - set(by_name)):
+        print('%-28s not found in call graph' % name)
+        failed = True
+
+    print('Indirect calls counted as %d bytes, external calls as %d bytes.'
+          % (args.indirect, args.external))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())